@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#if defined(__linux__)
+    #include <sched.h>
+#endif
+
+#include "SpinWait.h" // cpu_relax_once / wait_on: the run's wait kernel
+
+namespace lt {
+
+static inline void yield_cpu() {
+#if defined(__linux__)
+    sched_yield();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Tuning constants inspired by reference implementation (libslock ticket back-off)
+constexpr unsigned TICKET_BASE_WAIT = 4u;
+constexpr unsigned TICKET_WAIT_NEXT = 1u;
+
+// Run-time knobs shared by all back-off policies (set per run from the CLI).
+struct BackoffParams {
+    unsigned base = TICKET_BASE_WAIT; // relax rounds of the first / constant wait
+    unsigned max = 1024;              // cap for the exponential policies
+    unsigned yieldAfter = 20;         // ticket locks: sched_yield when more than this many ahead (0 = never)
+};
+
+// Back-off policies. One instance lives for a single acquisition attempt; pause(distance)
+// is called after every failed attempt, where distance is the number of holders/waiters
+// ahead of us (ticket locks) or 1 when unknown (TAS locks).
+
+// No back-off: retry at once (busy_relax_once: empty under the default wait kernel).
+struct NoBackoff {
+    static constexpr const char* kName = "none";
+    explicit NoBackoff(const BackoffParams&) {}
+    inline void pause(std::uint32_t) { busy_relax_once(); }
+};
+
+// Fixed wait of `base` relax rounds.
+struct ConstantBackoff {
+    static constexpr const char* kName = "const";
+    explicit ConstantBackoff(const BackoffParams& p) : p_(p) {}
+    inline void pause(std::uint32_t distance) {
+        cpu_relax_n(p_.base);
+        maybe_yield(distance);
+    }
+    inline void maybe_yield(std::uint32_t distance) const {
+        if (p_.yieldAfter != 0 && distance > p_.yieldAfter) yield_cpu();
+    }
+    const BackoffParams& p_;
+};
+
+// Wait proportional to the queue distance (libslock ticket back-off).
+struct ProportionalBackoff : ConstantBackoff {
+    static constexpr const char* kName = "prop";
+    using ConstantBackoff::ConstantBackoff;
+    inline void pause(std::uint32_t distance) {
+        cpu_relax_n(distance > 1 ? distance * p_.base : TICKET_WAIT_NEXT);
+        maybe_yield(distance);
+    }
+};
+
+// Truncated exponential: base, 2*base, ... up to max.
+struct ExpBackoff : ConstantBackoff {
+    static constexpr const char* kName = "exp";
+    explicit ExpBackoff(const BackoffParams& p) : ConstantBackoff(p), wait_(p.base ? p.base : 1) {}
+    inline void pause(std::uint32_t distance) {
+        cpu_relax_n(wait_);
+        if (wait_ < p_.max) wait_ = (wait_ * 2 < p_.max) ? wait_ * 2 : p_.max;
+        maybe_yield(distance);
+    }
+    unsigned wait_;
+};
+
+// Randomized exponential: uniform in [1, window], window doubles up to max. Uses a
+// per-thread xorshift state, so no shared cache line is touched.
+struct RandExpBackoff : ExpBackoff {
+    static constexpr const char* kName = "rexp";
+    using ExpBackoff::ExpBackoff;
+    inline void pause(std::uint32_t distance) {
+        cpu_relax_n(1 + static_cast<unsigned>(next_random() % wait_));
+        if (wait_ < p_.max) wait_ = (wait_ * 2 < p_.max) ? wait_ * 2 : p_.max;
+        maybe_yield(distance);
+    }
+    static inline std::uint64_t next_random() {
+        static thread_local std::uint64_t s = 0;
+        if (s == 0) s = reinterpret_cast<std::uintptr_t>(&s) | 1; // distinct seed per thread
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return s;
+    }
+};
+
+// What a lock keeps for its Backoff policy: a copy of the run's BackoffParams, or nothing
+// for NoBackoff. Locks derive from it, so the empty case costs no space (empty base).
+template <class Backoff> class BackoffStore {
+protected:
+    explicit BackoffStore(const BackoffParams& params) : params_(params) {}
+    const BackoffParams& backoff_params() const { return params_; }
+
+private:
+    BackoffParams params_;
+};
+
+template <> class BackoffStore<NoBackoff> {
+protected:
+    explicit BackoffStore(const BackoffParams&) {}
+    BackoffParams backoff_params() const { return {}; } // NoBackoff never reads it
+};
+
+// A waiter that just loaded `seen` from word: a back-off policy delays by its schedule,
+// NoBackoff waits for the word itself to change (busy_wait_on: monitor/WFE kernels sleep on
+// it, the default kernel re-reads at once as these loops always did).
+template <class Backoff, class T>
+inline void backoff_wait(Backoff& bo, const std::atomic<T>& word, T seen, std::uint32_t distance) {
+    if constexpr (std::is_same_v<Backoff, NoBackoff>) {
+        (void)bo; (void)distance;
+        busy_wait_on(word, seen);
+    } else {
+        bo.pause(distance);
+    }
+}
+
+} // namespace lt
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace lt {
+
+// Cache line size for alignment and padding across locks, tasks and the harness. Fixed at
+// 64 instead of std::hardware_destructive_interference_size, whose value follows -mtune
+// (GCC warns about it, -Winterference-size) and would change layouts between builds.
+constexpr std::size_t kCacheLine = 64;
+
+} // namespace lt
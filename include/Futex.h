@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <thread>
+#if defined(__linux__)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace lt {
+
+static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex word must be a plain 32-bit int");
+
+// Block while *addr == expected (spurious wake-ups allowed; callers re-check in a loop).
+// Outside Linux this degrades to a yield so the futex locks stay usable, just not parking.
+// processShared selects the plain FUTEX_WAIT/WAKE ops, keyed by the backing page instead of
+// the address space, for words in memory mapped by several processes.
+static inline void futex_wait(std::atomic<int>* addr, int expected, bool processShared = false) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<int*>(addr), processShared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE, expected,
+            nullptr, nullptr, 0);
+#else
+    (void)processShared;
+    if (addr->load(std::memory_order_relaxed) == expected) std::this_thread::yield();
+#endif
+}
+
+// Wake up to n threads blocked in futex_wait on addr.
+static inline void futex_wake(std::atomic<int>* addr, int n, bool processShared = false) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<int*>(addr), processShared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, n, nullptr,
+            nullptr, 0);
+#else
+    (void)addr; (void)n; (void)processShared;
+#endif
+}
+
+} // namespace lt
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#if defined(__x86_64__) || defined(__i386__)
+    #include <cpuid.h>
+    #include <immintrin.h>
+    #include <x86intrin.h>
+#endif
+#if defined(__aarch64__) && defined(__linux__)
+    #include <sys/auxv.h>
+    #include <asm/hwcap.h>
+#endif
+
+namespace lt {
+
+// What a spinning waiter executes for one round of its wait loop ("wait kernel"). One kernel
+// is active per run (set_wait_config()); every spin loop in the locks goes through
+// cpu_relax_once() (a round with nothing specific to watch) or wait_on() (a round waiting for
+// one word to change), so switching kernels needs no lock changes. Loops that busy-waited
+// with an empty body before this layer (spin, spin_preload, ticket, the MCS/CLH/cohort queue
+// waits) go through busy_relax_once() / busy_wait_on() instead: identical under any chosen
+// kernel, but still empty under the default one so their numbers stay comparable.
+enum class WaitKernel : std::uint8_t {
+    Default, // "default": every loop as before the kernel layer -- PAUSE (x86) where it paused,
+             //            nothing where the body was empty
+    Spin,   // "spin": compiler barrier only, the loop re-reads at full speed
+    Pause,  // "pause": x86 PAUSE, yields issue slots to the SMT sibling
+    Tpause, // "tpause": x86 WAITPKG TPAUSE in C0.1 for `ticks` TSC ticks
+    Umwait, // "umwait": x86 WAITPKG UMONITOR on the watched line, then UMWAIT (C0.1, at most `ticks`);
+            //           rounds without a watched word use TPAUSE
+    Yield,  // "yield": Arm YIELD hint
+    Wfe,    // "wfe": Arm load-exclusive of the watched word, then WFE until the line is written
+            //        (or the kernel's event stream fires); rounds without a watched word use YIELD
+};
+
+struct WaitConfig {
+    WaitKernel kernel;
+    std::uint32_t ticks; // tpause / umwait: TSC deadline of one round, from now
+};
+
+// TPAUSE: a few PAUSEs' worth per round. UMWAIT: it returns on the write anyway; the OS caps
+// the sleep via IA32_UMWAIT_CONTROL (100000 ticks by default on Linux).
+constexpr std::uint32_t kDefaultTpauseTicks = 500;
+constexpr std::uint32_t kDefaultUmwaitTicks = 100000;
+
+// The historical behaviour of each loop (see WaitKernel::Default).
+constexpr WaitKernel kDefaultWaitKernel = WaitKernel::Default;
+
+namespace detail {
+
+// Written between runs only (workers are started or released after it), read on every round.
+inline WaitConfig g_waitConfig {kDefaultWaitKernel, 0};
+
+#if defined(__x86_64__) || defined(__i386__)
+inline void x86_tpause(std::uint32_t ticks) {
+    const std::uint64_t deadline = __rdtsc() + ticks;
+    // ecx bit 0 = 1: C0.1, the light state with the faster wake-up
+    asm volatile("tpause %%ecx"
+                 : : "c"(1u), "a"(static_cast<std::uint32_t>(deadline)), "d"(static_cast<std::uint32_t>(deadline >> 32))
+                 : "memory", "cc");
+}
+inline void x86_umonitor(const void* addr) { asm volatile("umonitor %0" : : "r"(addr) : "memory"); }
+inline void x86_umwait(std::uint32_t ticks) {
+    const std::uint64_t deadline = __rdtsc() + ticks;
+    asm volatile("umwait %%ecx"
+                 : : "c"(1u), "a"(static_cast<std::uint32_t>(deadline)), "d"(static_cast<std::uint32_t>(deadline >> 32))
+                 : "memory", "cc");
+}
+#endif
+
+#if defined(__aarch64__)
+// Load-exclusive arms the monitor on the word's granule; a store by another CPU clears it and
+// raises the event that ends WFE. Returns the loaded bits.
+template <std::size_t N>
+inline std::uint64_t arm_load_exclusive(const volatile void* addr) {
+    std::uint64_t v;
+    if constexpr (N == 1) {
+        asm volatile("ldxrb %w0, [%1]" : "=&r"(v) : "r"(addr) : "memory");
+    } else if constexpr (N == 2) {
+        asm volatile("ldxrh %w0, [%1]" : "=&r"(v) : "r"(addr) : "memory");
+    } else if constexpr (N == 4) {
+        asm volatile("ldxr %w0, [%1]" : "=&r"(v) : "r"(addr) : "memory");
+    } else {
+        asm volatile("ldxr %0, [%1]" : "=&r"(v) : "r"(addr) : "memory");
+    }
+    return v;
+}
+#endif
+
+template <class T>
+inline std::uint64_t value_bits(T v) {
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &v, sizeof(T));
+    return bits;
+}
+
+} // namespace detail
+
+// CPUID.(EAX=7,ECX=0):ECX[5] (Tremont, Alder Lake, Sapphire Rapids and later).
+inline bool waitpkg_supported() {
+    static const bool supported = [] {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned a, b, c, d;
+        return __get_cpuid_count(7, 0, &a, &b, &c, &d) != 0 && ((c >> 5) & 1u) != 0;
+#else
+        return false;
+#endif
+    }();
+    return supported;
+}
+
+// ARMv8.1 LSE atomics (CAS, SWP, LDADD) on this CPU. GCC's default -moutline-atomics picks
+// them at run time; -march=armv8.1-a (or later) inlines them.
+inline bool lse_supported() {
+#if defined(__aarch64__) && defined(__linux__) && defined(HWCAP_ATOMICS)
+    return (getauxval(AT_HWCAP) & HWCAP_ATOMICS) != 0;
+#else
+    return false;
+#endif
+}
+
+inline bool wait_kernel_supported(WaitKernel k) {
+    switch (k) {
+    case WaitKernel::Default:
+    case WaitKernel::Spin: return true;
+#if defined(__x86_64__) || defined(__i386__)
+    case WaitKernel::Pause: return true;
+    case WaitKernel::Tpause:
+    case WaitKernel::Umwait: return waitpkg_supported();
+#elif defined(__aarch64__)
+    case WaitKernel::Yield:
+    case WaitKernel::Wfe: return true;
+#endif
+    default: return false;
+    }
+}
+
+inline const char* wait_kernel_name(WaitKernel k) {
+    switch (k) {
+    case WaitKernel::Default: return "default";
+    case WaitKernel::Spin: return "spin";
+    case WaitKernel::Pause: return "pause";
+    case WaitKernel::Tpause: return "tpause";
+    case WaitKernel::Umwait: return "umwait";
+    case WaitKernel::Yield: return "yield";
+    case WaitKernel::Wfe: return "wfe";
+    }
+    return "?";
+}
+
+// Kernel names plus "auto": the best supported kernel that waits on the watched line
+// (umwait with WAITPKG, wfe on Arm, else the default).
+inline bool parse_wait_kernel(const std::string& name, WaitKernel& out) {
+    if (name == "auto") {
+        if (wait_kernel_supported(WaitKernel::Umwait)) out = WaitKernel::Umwait;
+        else if (wait_kernel_supported(WaitKernel::Wfe)) out = WaitKernel::Wfe;
+        else out = kDefaultWaitKernel;
+        return true;
+    }
+    for (WaitKernel k : {WaitKernel::Default, WaitKernel::Spin, WaitKernel::Pause, WaitKernel::Tpause, WaitKernel::Umwait, WaitKernel::Yield,
+                         WaitKernel::Wfe}) {
+        if (name == wait_kernel_name(k)) {
+            out = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline std::uint32_t default_wait_ticks(WaitKernel k) {
+    return k == WaitKernel::Umwait ? kDefaultUmwaitTicks : k == WaitKernel::Tpause ? kDefaultTpauseTicks : 0;
+}
+
+// Must not run while workers spin; an unsupported kernel is replaced by the default.
+inline void set_wait_config(WaitConfig c) {
+    if (!wait_kernel_supported(c.kernel)) c = WaitConfig{kDefaultWaitKernel, 0};
+    if (c.ticks == 0) c.ticks = default_wait_ticks(c.kernel);
+    detail::g_waitConfig = c;
+}
+
+inline const WaitConfig& wait_config() { return detail::g_waitConfig; }
+
+// One round of a wait loop with no single word to watch (back-off delays, polling several
+// words). Kernels of the other architecture are never active, so their cases fold away.
+static inline void cpu_relax_once() {
+    switch (detail::g_waitConfig.kernel) {
+#if defined(__x86_64__) || defined(__i386__)
+    case WaitKernel::Default:
+    case WaitKernel::Pause:
+        _mm_pause();
+        return;
+    case WaitKernel::Tpause:
+    case WaitKernel::Umwait:
+        detail::x86_tpause(detail::g_waitConfig.ticks);
+        return;
+#elif defined(__aarch64__)
+    case WaitKernel::Yield:
+    case WaitKernel::Wfe:
+        asm volatile("yield" : : : "memory");
+        return;
+#endif
+    default:
+        // Prevent aggressive compiler reordering; very light-weight
+        asm volatile("");
+        return;
+    }
+}
+
+static inline void cpu_relax_n(unsigned n) {
+    while (n--) cpu_relax_once();
+}
+
+// One round of waiting for word to stop holding `seen` (the caller re-loads it afterwards
+// with its own ordering; spurious returns are fine). The monitoring kernels arm the monitor
+// first and re-check, so a store between the caller's load and the wait is not missed.
+template <class T>
+inline void wait_on(const std::atomic<T>& word, T seen) {
+    static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= 8, "wait_on needs a word-sized atomic");
+#if defined(__x86_64__) || defined(__i386__)
+    if (detail::g_waitConfig.kernel == WaitKernel::Umwait) {
+        detail::x86_umonitor(&word);
+        if (detail::value_bits(word.load(std::memory_order_relaxed)) == detail::value_bits(seen)) {
+            detail::x86_umwait(detail::g_waitConfig.ticks);
+        }
+        return;
+    }
+#elif defined(__aarch64__)
+    if (detail::g_waitConfig.kernel == WaitKernel::Wfe) {
+        if (detail::arm_load_exclusive<sizeof(T)>(&word) == detail::value_bits(seen)) asm volatile("wfe" : : : "memory");
+        return;
+    }
+#endif
+    cpu_relax_once();
+}
+
+// Spins while word == seen; returns the first other value loaded with `order`.
+template <class T>
+inline T spin_while_equal(const std::atomic<T>& word, T seen, std::memory_order order = std::memory_order_acquire) {
+    T v;
+    while (detail::value_bits(v = word.load(order)) == detail::value_bits(seen)) wait_on(word, seen);
+    return v;
+}
+
+// A round of a loop whose body was empty before the kernel layer: still empty (a compiler
+// barrier) under the default kernel, cpu_relax_once() / wait_on() under any other.
+static inline void busy_relax_once() {
+    if (detail::g_waitConfig.kernel == WaitKernel::Default) {
+        asm volatile("");
+        return;
+    }
+    cpu_relax_once();
+}
+
+template <class T>
+inline void busy_wait_on(const std::atomic<T>& word, T seen) {
+    if (detail::g_waitConfig.kernel == WaitKernel::Default) {
+        asm volatile("");
+        return;
+    }
+    wait_on(word, seen);
+}
+
+// spin_while_equal() over busy_wait_on().
+template <class T>
+inline T busy_spin_while_equal(const std::atomic<T>& word, T seen, std::memory_order order = std::memory_order_acquire) {
+    T v;
+    while (detail::value_bits(v = word.load(order)) == detail::value_bits(seen)) busy_wait_on(word, seen);
+    return v;
+}
+
+// "umwait (waitpkg, 100000 ticks)": active kernel and the CPU features behind it.
+inline std::string wait_kernel_summary() {
+    const WaitConfig& c = wait_config();
+    std::string detail;
+#if defined(__x86_64__) || defined(__i386__)
+    detail = waitpkg_supported() ? "waitpkg" : "no waitpkg";
+#elif defined(__aarch64__)
+    detail = lse_supported() ? "lse" : "no lse";
+#endif
+    if (c.kernel == WaitKernel::Tpause || c.kernel == WaitKernel::Umwait) {
+        detail += ", " + std::to_string(c.ticks) + " ticks";
+    }
+    return detail.empty() ? std::string(wait_kernel_name(c.kernel)) : std::string(wait_kernel_name(c.kernel)) + " (" + detail + ")";
+}
+
+} // namespace lt
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#if defined(__linux__)
+    #include <sched.h>
+#endif
+
+namespace lt {
+
+// Dense per-thread id ("slot") used by locks that keep per-thread state in a preallocated
+// array instead of a thread_local map. LockTestSys assigns worker i slot i before the
+// measured loop; any other thread gets the next free id of a range reserved above the
+// workers on first use, so the two never collide. Either way a slot is always below
+// kDefaultMaxThreadSlots; arrays of that size need no check.
+constexpr int kDefaultMaxThreadSlots = 1024;
+constexpr int kAutoThreadSlots = 64;                                       // top of the slot space
+constexpr int kMaxWorkerThreadSlots = kDefaultMaxThreadSlots - kAutoThreadSlots; // [0, this) for set_this_thread_slot()
+
+// Per-slot arrays are sized for the run's threads; indexing one with a larger slot is a
+// harness or caller bug that would corrupt memory, so it stops the process in every build.
+[[noreturn]] inline void thread_slot_overflow(const char* what, int slot, int capacity) {
+    std::fprintf(stderr, "%s: thread slot %d exceeds capacity %d\n", what, slot, capacity);
+    std::abort();
+}
+
+namespace detail {
+inline int& thread_slot_ref() {
+    static thread_local int slot = -1;
+    return slot;
+}
+inline int& thread_numa_node_ref() {
+    static thread_local int node = -1;
+    return node;
+}
+inline std::atomic<int>& next_auto_slot() {
+    static std::atomic<int> next{kMaxWorkerThreadSlots};
+    return next;
+}
+} // namespace detail
+
+// The harness calls this after pinning a worker for a run; since pooled workers may be
+// re-pinned between runs it also drops the cached NUMA node.
+inline void set_this_thread_slot(int slot) {
+    if (slot < 0 || slot >= kMaxWorkerThreadSlots) thread_slot_overflow("set_this_thread_slot", slot, kMaxWorkerThreadSlots);
+    detail::thread_slot_ref() = slot;
+    detail::thread_numa_node_ref() = -1;
+}
+
+inline int this_thread_slot() {
+    int& s = detail::thread_slot_ref();
+    if (s < 0) {
+        s = detail::next_auto_slot().fetch_add(1, std::memory_order_relaxed);
+        if (s >= kDefaultMaxThreadSlots) thread_slot_overflow("automatic thread slots", s, kDefaultMaxThreadSlots);
+    }
+    return s;
+}
+
+// this_thread_slot() for indexing an array of `capacity` per-slot entries.
+inline int checked_thread_slot(int capacity, const char* what) {
+    const int s = this_thread_slot();
+    if (s >= capacity) thread_slot_overflow(what, s, capacity);
+    return s;
+}
+
+// NUMA node of the calling thread, cached until the next set_this_thread_slot(). Workers
+// are pinned before that call, so the cached value stays valid for the whole run.
+inline int current_numa_node() {
+    int& node = detail::thread_numa_node_ref();
+    if (node < 0) {
+#if defined(__linux__)
+        unsigned cpu = 0, n = 0;
+        node = (getcpu(&cpu, &n) == 0) ? static_cast<int>(n) : 0;
+#else
+        node = 0;
+#endif
+    }
+    return node;
+}
+
+} // namespace lt
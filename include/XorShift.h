@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+namespace lt {
+
+// Small per-thread PRNG (xorshift64) for hot-loop decisions; no shared state.
+struct XorShift64 {
+    explicit XorShift64(std::uint64_t seed) : s(mix(seed)) {}
+
+    inline std::uint64_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return s;
+    }
+
+    // Uniform in [0, 1)
+    inline double uniform() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // splitmix64 finalizer so that small consecutive seeds (thread slots) give unrelated streams
+    static std::uint64_t mix(std::uint64_t z) {
+        z += 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        z ^= z >> 31;
+        return z ? z : 1;
+    }
+
+    std::uint64_t s;
+};
+
+} // namespace lt
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "iLock.h"
+#include <cstdint>
+
+namespace lt {
+
+// Lock-free baseline: the worker loop calls update() in place of lock/run_locked/unlock,
+// performing the critical section's logical update (one increment of shared state)
+// without a lock. lock()/unlock() remain available, so a baseline is still a valid iLock,
+// but the measured loop never uses them.
+class iAtomicBaseline : public iLock {
+public:
+    virtual void update() = 0;
+    // Increments applied so far (exact once all updating threads have stopped).
+    virtual std::uint64_t value() const = 0;
+};
+
+} // namespace lt
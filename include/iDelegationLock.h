@@ -0,0 +1,19 @@
+#pragma once
+
+#include "iLock.h"
+
+namespace lt {
+
+// Delegation interface: instead of acquiring the lock and running the critical section
+// itself, a thread hands the section to execute(), which may run it on another thread
+// (a combiner or a server) while the caller waits. Sections submitted through one
+// instance are mutually exclusive with each other and with lock()/unlock() holders.
+class iDelegationLock : public iLock {
+public:
+    using Section = void (*)(void* arg);
+
+    // Runs section(arg) under mutual exclusion and returns once it has completed.
+    virtual void execute(Section section, void* arg) = 0;
+};
+
+} // namespace lt
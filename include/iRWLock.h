@@ -0,0 +1,28 @@
+#pragma once
+
+#include "iLock.h"
+
+namespace lt {
+
+// Reader-writer lock interface: lock()/unlock() from iLock take the lock exclusively
+// (writers), lock_shared()/unlock_shared() admit concurrent readers.
+class iRWLock : public iLock {
+public:
+    virtual void lock_shared() = 0;
+    virtual void unlock_shared() = 0;
+};
+
+// RAII guard for the shared side of an iRWLock
+class SharedLockGuard {
+public:
+    explicit SharedLockGuard(iRWLock& lock) : lock_(lock) { lock_.lock_shared(); }
+    ~SharedLockGuard() { lock_.unlock_shared(); }
+
+    SharedLockGuard(const SharedLockGuard&) = delete;
+    SharedLockGuard& operator=(const SharedLockGuard&) = delete;
+
+private:
+    iRWLock& lock_;
+};
+
+} // namespace lt
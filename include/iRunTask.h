@@ -8,6 +8,12 @@ namespace lt {
 // Contract:
 // - run_parallel(): the major portion of work that can proceed without holding the lock.
 // - run_locked(): the small critical section that must be protected by the external lock.
+// - run_locked_read(): read-only critical section used under a shared (reader) lock;
+//   defaults to run_locked(), which is fine for tasks that write no shared state.
+// - run_locked_stripe(k): critical section under stripe k of a striped lock array; tasks
+//   with shared state keep one copy per stripe. Defaults to run_locked() for the same reason.
+// - prepare_thread(): called by every worker once per run after it is pinned and before the
+//   measured window, e.g. to first-touch per-thread memory on the worker's NUMA node.
 
 class iRunTask {
 public:
@@ -15,6 +21,9 @@ public:
     virtual void reset() = 0;
     virtual void run_parallel() = 0;   // executed outside of lock
     virtual void run_locked() = 0;     // executed under external lock
+    virtual void run_locked_read() { run_locked(); } // executed under external shared lock
+    virtual void run_locked_stripe(int /*stripe*/) { run_locked(); } // executed under lock stripe k
+    virtual void prepare_thread() {}   // executed by each pinned worker before the window
     virtual const char* name() const = 0;
 };
 
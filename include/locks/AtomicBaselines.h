@@ -0,0 +1,96 @@
+#pragma once
+
+#include "iAtomicBaseline.h"
+#include "Backoff.h"
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace lt {
+
+// Shared lock()/unlock() of the baselines: a TAS flag with local spinning.
+class AtomicBaselineBase : public iAtomicBaseline {
+public:
+    void lock() override {
+        while (held_.exchange(true, std::memory_order_acquire)) {
+            spin_while_equal(held_, true, std::memory_order_relaxed);
+        }
+    }
+    void unlock() override { held_.store(false, std::memory_order_release); }
+
+private:
+    alignas(kCacheLine) std::atomic<bool> held_{false};
+};
+
+// One fetch_add per operation on a shared counter: the hardware's atomic ceiling.
+class FetchAddBaseline : public AtomicBaselineBase {
+public:
+    void update() override { counter_.fetch_add(1, std::memory_order_relaxed); }
+    std::uint64_t value() const override { return counter_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(kCacheLine) std::atomic<std::uint64_t> counter_{0};
+};
+
+// Load + compare_exchange retry loop on a shared counter: what a lock-free update of
+// state that has no single-instruction RMW costs under contention.
+class CasLoopBaseline : public AtomicBaselineBase {
+public:
+    void update() override {
+        std::uint64_t v = counter_.load(std::memory_order_relaxed);
+        while (!counter_.compare_exchange_weak(v, v + 1, std::memory_order_relaxed, std::memory_order_relaxed)) {
+            cpu_relax_once(); // v was refreshed by the failed CAS
+        }
+    }
+    std::uint64_t value() const override { return counter_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(kCacheLine) std::atomic<std::uint64_t> counter_{0};
+};
+
+// Per-thread shards (indexed by this_thread_slot()) with periodic aggregation: each thread
+// counts on its own cache line and folds the local delta into the shared total every
+// kFoldEvery updates, so the shared line is written once per kFoldEvery operations.
+class ShardedCounterBaseline : public AtomicBaselineBase {
+public:
+    static constexpr std::uint64_t kFoldEvery = 256;
+
+    explicit ShardedCounterBaseline(int maxThreads = kDefaultMaxThreadSlots)
+        : capacity_(maxThreads > 0 ? maxThreads : 1), shards_(new Shard[static_cast<std::size_t>(capacity_)]) {}
+
+    void update() override {
+        Shard& s = shard_for_this_thread();
+        // single writer per shard: plain load/store, relaxed so value() may read it
+        const std::uint64_t pending = s.pending.load(std::memory_order_relaxed) + 1;
+        if (pending >= kFoldEvery) {
+            total_.fetch_add(pending, std::memory_order_relaxed);
+            s.pending.store(0, std::memory_order_relaxed);
+        } else {
+            s.pending.store(pending, std::memory_order_relaxed);
+        }
+    }
+
+    std::uint64_t value() const override {
+        std::uint64_t v = total_.load(std::memory_order_relaxed);
+        for (int i = 0; i < capacity_; ++i) v += shards_[static_cast<std::size_t>(i)].pending.load(std::memory_order_relaxed);
+        return v;
+    }
+
+private:
+    struct alignas(kCacheLine) Shard {
+        std::atomic<std::uint64_t> pending{0}; // updates not yet folded into total_
+    };
+
+    Shard& shard_for_this_thread() {
+        const int slot = checked_thread_slot(capacity_, "ShardedCounterBaseline");
+        return shards_[static_cast<std::size_t>(slot)];
+    }
+
+    const int capacity_;
+    std::unique_ptr<Shard[]> shards_;
+    alignas(kCacheLine) std::atomic<std::uint64_t> total_{0};
+};
+
+} // namespace lt
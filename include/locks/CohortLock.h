@@ -0,0 +1,113 @@
+#pragma once
+
+#include "iLock.h"
+#include "SpinWait.h"
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace lt {
+
+// NUMA-aware cohort lock (C-TKT-MCS, Dice/Marathe/Shavit): a global ticket lock plus one
+// MCS queue per NUMA node. The owner passes the lock (with the global ticket still held)
+// directly to a waiter of its own node up to `batch` times in a row; after that, or when
+// no local waiter exists, it releases the global lock so other nodes get a turn. The MCS
+// nodes are indexed by thread slot (see McsSlotLock), one per slot below maxThreads.
+class CohortLock : public iLock {
+public:
+    explicit CohortLock(int numNodes = 1, unsigned batch = 64, int maxThreads = kDefaultMaxThreadSlots)
+        : numNodes_(numNodes > 0 ? numNodes : 1), batch_(batch), capacity_(maxThreads > 0 ? maxThreads : 1),
+          cohorts_(new Cohort[static_cast<std::size_t>(numNodes_)]),
+          nodes_(new Node[static_cast<std::size_t>(capacity_)]) {}
+
+    void lock() override {
+        Cohort& c = cohorts_[static_cast<std::size_t>(current_numa_node() % numNodes_)];
+        Node& me = node_for_this_thread();
+        me.next.store(nullptr, std::memory_order_relaxed);
+        me.state.store(kWait, std::memory_order_relaxed);
+
+        Node* prev = c.tail.exchange(&me, std::memory_order_acq_rel);
+        if (prev != nullptr) {
+            prev->next.store(&me, std::memory_order_release);
+            // wait on our own node
+            const std::uint32_t st = busy_spin_while_equal(me.state, kWait);
+            if (st == kCohortPass) {
+                // predecessor handed over the global lock together with the local one
+                owner_ = &c;
+                return;
+            }
+        }
+        // Local lock is ours but the global one is not: queue on the global ticket
+        const std::uint32_t my = global_next_.fetch_add(1, std::memory_order_relaxed);
+        for (std::uint32_t s; (s = global_serving_.load(std::memory_order_acquire)) != my;) {
+            busy_wait_on(global_serving_, s);
+        }
+        c.passes = 0;
+        owner_ = &c;
+    }
+
+    void unlock() override {
+        Cohort& c = *owner_;
+        Node& me = node_for_this_thread();
+        Node* succ = me.next.load(std::memory_order_acquire);
+        if (succ == nullptr) {
+            Node* expected = &me;
+            if (c.tail.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel,
+                                               std::memory_order_relaxed)) {
+                // Cohort empty: release the global lock for other nodes
+                release_global();
+                return;
+            }
+            succ = busy_spin_while_equal(me.next, static_cast<Node*>(nullptr));
+        }
+        if (c.passes < batch_) {
+            // Local handover; passes is only touched by the cohort's current owner
+            ++c.passes;
+            succ->state.store(kCohortPass, std::memory_order_release);
+        } else {
+            // Batch exhausted: give the global lock back, successor must re-acquire it
+            release_global();
+            succ->state.store(kAcquireGlobal, std::memory_order_release);
+        }
+    }
+
+    int numNodes() const { return numNodes_; }
+    unsigned batch() const { return batch_; }
+
+private:
+    static constexpr std::uint32_t kWait = 0;          // still queued on the local MCS lock
+    static constexpr std::uint32_t kAcquireGlobal = 1; // local lock passed, global must be taken
+    static constexpr std::uint32_t kCohortPass = 2;    // local and global lock passed together
+
+    struct alignas(kCacheLine) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<std::uint32_t> state{kWait};
+    };
+
+    struct alignas(kCacheLine) Cohort {
+        std::atomic<Node*> tail{nullptr};
+        unsigned passes{0}; // consecutive local handovers, protected by the local lock
+    };
+
+    void release_global() {
+        global_serving_.store(global_serving_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    Node& node_for_this_thread() {
+        const int slot = checked_thread_slot(capacity_, "CohortLock");
+        return nodes_[static_cast<std::size_t>(slot)];
+    }
+
+    const int numNodes_;
+    const unsigned batch_;
+    const int capacity_;
+    std::unique_ptr<Cohort[]> cohorts_;
+    std::unique_ptr<Node[]> nodes_;
+    Cohort* owner_{nullptr}; // cohort of the current holder; written and read only under the lock
+    alignas(kCacheLine) std::atomic<std::uint32_t> global_next_{0};
+    alignas(kCacheLine) std::atomic<std::uint32_t> global_serving_{0};
+};
+
+} // namespace lt
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "iDelegationLock.h"
+#include "Backoff.h"
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace lt {
+
+// Per-thread publication slots indexed by this_thread_slot(). A client writes arg, then
+// publishes the section with a release store; whoever serves it runs the section and
+// clears the slot with a release store, which is what the client spins on.
+class RequestSlots {
+public:
+    struct alignas(kCacheLine) Slot {
+        std::atomic<iDelegationLock::Section> section{nullptr}; // non-null = pending
+        void* arg{nullptr};
+    };
+
+    explicit RequestSlots(int maxThreads)
+        : capacity_(maxThreads > 0 ? maxThreads : 1), slots_(new Slot[static_cast<std::size_t>(capacity_)]) {}
+
+    Slot& for_this_thread() {
+        const int slot = checked_thread_slot(capacity_, "delegation lock");
+        return slots_[static_cast<std::size_t>(slot)];
+    }
+
+    // One pass over all slots, running every pending section; returns how many ran.
+    // Caller must hold the engine's exclusion flag.
+    int serve_all() {
+        int served = 0;
+        for (int i = 0; i < capacity_; ++i) {
+            Slot& s = slots_[static_cast<std::size_t>(i)];
+            iDelegationLock::Section fn = s.section.load(std::memory_order_acquire);
+            if (fn == nullptr) continue;
+            fn(s.arg);
+            s.section.store(nullptr, std::memory_order_release);
+            ++served;
+        }
+        return served;
+    }
+
+private:
+    const int capacity_;
+    std::unique_ptr<Slot[]> slots_;
+};
+
+// Flat combining (Hendler, Incze, Shavit, Tzafrir 2010): a thread publishes its request,
+// and whichever thread wins the combiner flag runs every pending request in a few passes
+// over the slot array, so the protected data stays in the combiner's cache.
+// lock()/unlock() take the combiner flag directly (a TAS lock with local spinning).
+class FlatCombiningLock : public iDelegationLock {
+public:
+    explicit FlatCombiningLock(int maxThreads = kDefaultMaxThreadSlots) : slots_(maxThreads) {}
+
+    void lock() override {
+        while (combiner_.exchange(true, std::memory_order_acquire)) {
+            spin_while_equal(combiner_, true, std::memory_order_relaxed);
+        }
+    }
+
+    void unlock() override { combiner_.store(false, std::memory_order_release); }
+
+    void execute(Section section, void* arg) override {
+        RequestSlots::Slot& me = slots_.for_this_thread();
+        me.arg = arg;
+        me.section.store(section, std::memory_order_release);
+        for (;;) {
+            if (me.section.load(std::memory_order_acquire) == nullptr) return; // served by a combiner
+            if (!combiner_.load(std::memory_order_relaxed) && !combiner_.exchange(true, std::memory_order_acquire)) {
+                // we are the combiner: our own request is among the pending ones
+                for (unsigned pass = 0; pass < kCombinePasses; ++pass) {
+                    if (slots_.serve_all() == 0) break;
+                }
+                combiner_.store(false, std::memory_order_release);
+            } else {
+                cpu_relax_once();
+            }
+        }
+    }
+
+private:
+    static constexpr unsigned kCombinePasses = 3; // extra passes pick up requests published meanwhile
+
+    RequestSlots slots_;
+    alignas(kCacheLine) std::atomic<bool> combiner_{false};
+};
+
+// Server-based delegation in the spirit of RCL / ffwd: a dedicated server thread owned by
+// the lock polls the slot array and runs every request, so clients never touch the shared
+// data. The server thread is not pinned: it runs wherever the OS schedules it (any CPU of
+// the process's affinity mask, usually shared with the workers) and yields after a long run
+// of empty scans, so it stays cheap between runs; for ffwd-like numbers give it a core
+// outside --placement. One server per instance, hence no --stripes > 1 in the harness.
+// lock()/unlock() exclude the server through the same flag it holds while serving.
+class ServerDelegationLock : public iDelegationLock {
+public:
+    explicit ServerDelegationLock(int maxThreads = kDefaultMaxThreadSlots)
+        : slots_(maxThreads), server_([this] { serve(); }) {}
+
+    ~ServerDelegationLock() override {
+        quit_.store(true, std::memory_order_relaxed);
+        server_.join();
+    }
+
+    void lock() override {
+        while (held_.exchange(true, std::memory_order_acquire)) {
+            spin_while_equal(held_, true, std::memory_order_relaxed);
+        }
+    }
+
+    void unlock() override { held_.store(false, std::memory_order_release); }
+
+    void execute(Section section, void* arg) override {
+        RequestSlots::Slot& me = slots_.for_this_thread();
+        me.arg = arg;
+        me.section.store(section, std::memory_order_release);
+        for (Section s; (s = me.section.load(std::memory_order_acquire)) != nullptr;) wait_on(me.section, s);
+    }
+
+private:
+    static constexpr unsigned kIdleScansBeforeYield = 1u << 14;
+
+    void serve() {
+        unsigned idle = 0;
+        while (!quit_.load(std::memory_order_relaxed)) {
+            if (held_.exchange(true, std::memory_order_acquire)) {
+                cpu_relax_once(); // a lock() holder is inside
+                continue;
+            }
+            const int served = slots_.serve_all();
+            held_.store(false, std::memory_order_release);
+            if (served != 0) {
+                idle = 0;
+            } else if (++idle >= kIdleScansBeforeYield) {
+                yield_cpu();
+                idle = 0;
+            }
+        }
+    }
+
+    RequestSlots slots_;
+    alignas(kCacheLine) std::atomic<bool> held_{false};
+    alignas(kCacheLine) std::atomic<bool> quit_{false};
+    std::thread server_; // last: starts after the slots and flags are constructed
+};
+
+} // namespace lt
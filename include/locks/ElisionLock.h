@@ -0,0 +1,167 @@
+#pragma once
+
+#include "iLock.h"
+#include "Backoff.h"
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace lt {
+
+// Retry policy of ElidedLock.
+struct ElisionPolicy {
+    unsigned retries {3};    // transactional attempts before taking the real lock
+    bool followHints {true}; // stop early on an abort without the hardware's RETRY hint (capacity, ...)
+};
+
+// Why a transaction aborted (one counter each; a status with several bits counts as the first).
+enum ElisionAbort : int {
+    kAbortConflict = 0, // another CPU touched the read/write set
+    kAbortCapacity,     // the write set (or read set) overflowed the cache
+    kAbortBusy,         // explicit abort: the lock was held by a fallback owner
+    kAbortOther,        // debug/nested/explicit with another code, or no reason (interrupt, TSX disabled)
+    kNumElisionAborts
+};
+
+// Elision outcomes summed over all ElidedLocks and threads since process start.
+struct ElisionCounts {
+    std::uint64_t commits {0};   // critical sections that ran and committed as a transaction
+    std::uint64_t fallbacks {0}; // acquisitions that took the real lock
+    std::uint64_t aborts[kNumElisionAborts] {};
+};
+
+namespace detail {
+
+struct alignas(kCacheLine) ElisionSlot {
+    ElisionCounts counts;
+};
+
+// Per-slot counters shared by every ElidedLock, so counting never writes a shared line
+// (which would itself abort the other threads' transactions).
+inline ElisionSlot* elision_slots() {
+    static ElisionSlot slots[kDefaultMaxThreadSlots];
+    return slots;
+}
+
+// RTM through the raw mnemonics, so no -mrtm / target attribute is needed: xbegin falls
+// through with eax untouched (~0) when the transaction starts, and on abort resumes at the
+// label with the abort status in eax.
+constexpr unsigned kRtmStarted = ~0u;
+constexpr unsigned kRtmExplicit = 1u << 0;
+constexpr unsigned kRtmRetry = 1u << 1;
+constexpr unsigned kRtmConflict = 1u << 2;
+constexpr unsigned kRtmCapacity = 1u << 3;
+constexpr unsigned kRtmBusyCode = 0xff; // our xabort code: lock observed held
+
+#if defined(__x86_64__) || defined(__i386__)
+inline unsigned rtm_begin() {
+    unsigned status = kRtmStarted;
+    asm volatile("xbegin 1f\n1:" : "+a"(status) : : "memory");
+    return status;
+}
+inline void rtm_end() { asm volatile("xend" : : : "memory"); }
+inline void rtm_abort_busy() { asm volatile("xabort $0xff" : : : "memory"); }
+inline bool rtm_test() {
+    unsigned char in;
+    asm volatile("xtest\n\tsetnz %0" : "=q"(in) : : "memory", "cc");
+    return in != 0;
+}
+#else
+inline unsigned rtm_begin() { return 0; }
+inline void rtm_end() {}
+inline void rtm_abort_busy() {}
+inline bool rtm_test() { return false; }
+#endif
+
+inline int classify_abort(unsigned status) {
+    if (status & kRtmConflict) return kAbortConflict;
+    if (status & kRtmCapacity) return kAbortCapacity;
+    if ((status & kRtmExplicit) && (status >> 24) == kRtmBusyCode) return kAbortBusy;
+    return kAbortOther;
+}
+
+} // namespace detail
+
+// CPUID.(EAX=7,ECX=0):EBX[11]; false on other architectures. Microcode that disables TSX
+// clears the bit, or leaves it set and aborts every transaction (counted as "other").
+inline bool rtm_supported() {
+    static const bool supported = [] {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned a, b, c, d;
+        return __get_cpuid_count(7, 0, &a, &b, &c, &d) != 0 && ((b >> 11) & 1u) != 0;
+#else
+        return false;
+#endif
+    }();
+    return supported;
+}
+
+inline ElisionCounts elision_counts() {
+    ElisionCounts sum;
+    const detail::ElisionSlot* slots = detail::elision_slots();
+    for (int s = 0; s < kDefaultMaxThreadSlots; ++s) {
+        sum.commits += slots[s].counts.commits;
+        sum.fallbacks += slots[s].counts.fallbacks;
+        for (int k = 0; k < kNumElisionAborts; ++k) sum.aborts[k] += slots[s].counts.aborts[k];
+    }
+    return sum;
+}
+
+// Hardware lock elision (Intel RTM) over any iLock: lock() runs the critical section as a
+// transaction and only takes the wrapped lock after policy.retries failed attempts. iLock
+// exposes no "is it held" query, so the wrapper keeps its own fallback word: a fallback owner
+// sets it (with a full fence) after acquiring the real lock and clears it before releasing;
+// transactions read it right after xbegin, so it sits in their read set and a fallback
+// acquisition aborts them all. Without RTM every acquisition is a fallback.
+template <class L>
+class ElidedLock : public iLock {
+public:
+    template <class... Args>
+    explicit ElidedLock(ElisionPolicy policy, Args&&... args)
+        : policy_(policy), rtm_(rtm_supported()), inner_(std::forward<Args>(args)...) {}
+
+    void lock() override {
+        ElisionCounts& st = detail::elision_slots()[this_thread_slot()].counts;
+        if (rtm_) {
+            for (unsigned attempt = 0; attempt < policy_.retries; ++attempt) {
+                // a transaction started while the word is set would only abort on it
+                spin_while_equal(held_, 1u, std::memory_order_relaxed);
+                const unsigned status = detail::rtm_begin();
+                if (status == detail::kRtmStarted) {
+                    if (held_.load(std::memory_order_relaxed) == 0) return; // elided: word in the read set
+                    detail::rtm_abort_busy();
+                }
+                const int kind = detail::classify_abort(status);
+                ++st.aborts[kind];
+                if (policy_.followHints && kind != kAbortBusy && !(status & detail::kRtmRetry)) break;
+            }
+        }
+        ++st.fallbacks;
+        inner_.lock();
+        // seq_cst: the word must be visible before the first access of the critical section
+        if (rtm_) held_.store(1, std::memory_order_seq_cst);
+    }
+
+    void unlock() override {
+        if (rtm_ && detail::rtm_test()) {
+            detail::rtm_end();
+            ++detail::elision_slots()[this_thread_slot()].counts.commits;
+            return;
+        }
+        if (rtm_) held_.store(0, std::memory_order_release);
+        inner_.unlock();
+    }
+
+private:
+    const ElisionPolicy policy_;
+    const bool rtm_;
+    std::atomic<std::uint32_t> held_ {0}; // 1 while a fallback owner holds inner_
+    L inner_;
+};
+
+} // namespace lt
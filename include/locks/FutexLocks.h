@@ -0,0 +1,153 @@
+#pragma once
+
+#include "iLock.h"
+#include "Futex.h"
+#include "ThreadSlot.h"
+#include "Backoff.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace lt {
+
+// Default spin budget before a waiter parks in the kernel (lock attempts / relax rounds).
+constexpr unsigned kDefaultSpinBudget = 128;
+
+// Three-state futex mutex ("Futexes Are Tricky", Drepper, mutex #3).
+// state_: 0 = unlocked, 1 = locked without waiters, 2 = locked, waiters may be parked.
+// Shared = true uses non-private futexes, so an instance in a shared mapping also parks
+// and wakes waiters of other processes.
+template <bool Shared>
+class BasicFutexLock : public iLock {
+public:
+    BasicFutexLock() = default;
+
+    void lock() override {
+        int c = 0;
+        if (state_.compare_exchange_strong(c, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return;
+        }
+        lock_slow(c);
+    }
+
+    void unlock() override {
+        if (state_.fetch_sub(1, std::memory_order_release) != 1) {
+            // There may be parked waiters: fully release and wake one of them
+            state_.store(0, std::memory_order_release);
+            futex_wake(&state_, 1, Shared);
+        }
+    }
+
+protected:
+    // c: value observed by the failed fast-path CAS
+    void lock_slow(int c) {
+        if (c != 2) c = state_.exchange(2, std::memory_order_acquire);
+        while (c != 0) {
+            futex_wait(&state_, 2, Shared);
+            c = state_.exchange(2, std::memory_order_acquire);
+        }
+    }
+
+    std::atomic<int> state_{0};
+};
+
+// Spin-then-park: like FutexLock, but first retries the uncontended CAS for up to
+// spinBudget relax rounds (observing with plain loads) before taking the futex path.
+template <bool Shared>
+class BasicAdaptiveFutexLock : public BasicFutexLock<Shared> {
+public:
+    explicit BasicAdaptiveFutexLock(unsigned spinBudget = kDefaultSpinBudget) : spinBudget_(spinBudget) {}
+
+    void lock() override {
+        auto& state = this->state_;
+        int c = 0;
+        if (state.compare_exchange_strong(c, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return;
+        }
+        for (unsigned i = 0; i < spinBudget_; ++i) {
+            cpu_relax_once();
+            if (state.load(std::memory_order_relaxed) != 0) continue;
+            c = 0;
+            if (state.compare_exchange_weak(c, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        this->lock_slow(state.load(std::memory_order_relaxed));
+    }
+
+private:
+    const unsigned spinBudget_;
+};
+
+using FutexLock = BasicFutexLock<false>;
+using AdaptiveFutexLock = BasicAdaptiveFutexLock<false>;
+using SharedFutexLock = BasicFutexLock<true>;
+using SharedAdaptiveFutexLock = BasicAdaptiveFutexLock<true>;
+
+// MCS queue lock whose waiters spin on their own node for spinBudget rounds and then park
+// on it with FUTEX_WAIT. Queue nodes come from a slot array (see ThreadSlot.h).
+class McsParkLock : public iLock {
+public:
+    explicit McsParkLock(int maxThreads = kDefaultMaxThreadSlots, unsigned spinBudget = kDefaultSpinBudget)
+        : capacity_(maxThreads > 0 ? maxThreads : 1), spinBudget_(spinBudget),
+          nodes_(new Node[static_cast<std::size_t>(capacity_)]) {}
+
+    void lock() override {
+        Node& me = node_for_this_thread();
+        me.next.store(nullptr, std::memory_order_relaxed);
+        me.state.store(kWaiting, std::memory_order_relaxed);
+
+        Node* prev = tail_.exchange(&me, std::memory_order_acq_rel);
+        if (prev == nullptr) return;
+        prev->next.store(&me, std::memory_order_release);
+        for (unsigned i = 0; i < spinBudget_; ++i) {
+            if (me.state.load(std::memory_order_acquire) == kGranted) return;
+            cpu_relax_once();
+        }
+        // Announce that we are going to sleep; the releaser wakes us only in that case
+        int expected = kWaiting;
+        if (me.state.compare_exchange_strong(expected, kParked, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            while (me.state.load(std::memory_order_acquire) == kParked) {
+                futex_wait(&me.state, kParked);
+            }
+        }
+    }
+
+    void unlock() override {
+        Node& me = node_for_this_thread();
+        Node* succ = me.next.load(std::memory_order_acquire);
+        if (succ == nullptr) {
+            Node* expected = &me;
+            if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return;
+            }
+            succ = busy_spin_while_equal(me.next, static_cast<Node*>(nullptr));
+        }
+        if (succ->state.exchange(kGranted, std::memory_order_acq_rel) == kParked) {
+            futex_wake(&succ->state, 1);
+        }
+    }
+
+private:
+    static constexpr int kWaiting = 0;
+    static constexpr int kParked = 1;
+    static constexpr int kGranted = 2;
+
+    struct alignas(kCacheLine) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<int> state{kWaiting};
+    };
+
+    Node& node_for_this_thread() {
+        const int slot = checked_thread_slot(capacity_, "McsParkLock");
+        return nodes_[static_cast<std::size_t>(slot)];
+    }
+
+    const int capacity_;
+    const unsigned spinBudget_;
+    std::unique_ptr<Node[]> nodes_;
+    alignas(kCacheLine) std::atomic<Node*> tail_{nullptr};
+};
+
+} // namespace lt
@@ -1,18 +1,13 @@
 #pragma once
 
 #include "iLock.h"
+#include "SpinWait.h"
+#include "CacheLine.h"
 #include <atomic>
 #include <cstdint>
 #include <unordered_map>
 
 namespace lt {
-// Determine cache line size at compile time; fallback to 64 if not available
-#if defined(__cpp_lib_hardware_interference_size)
-constexpr std::size_t kCacheLineSize = std::hardware_destructive_interference_size;
-#else
-constexpr std::size_t kCacheLineSize = 64;
-#endif
-static_assert(kCacheLineSize >= sizeof(std::uint64_t), "Cache line size must be >= 8 bytes");
 // MCS queue lock: scalable FIFO spinlock
 
 class McsLock : public iLock {
@@ -29,9 +24,7 @@ public:
             // Link ourselves after predecessor
             prev->next.store(&me, std::memory_order_release);
             // Wait until predecessor clears our locked flag
-            while (me.locked.load(std::memory_order_acquire)) {
-                // busy-wait
-            }
+            busy_spin_while_equal(me.locked, true);
         } else {
             // We acquired the lock directly
             me.locked.store(false, std::memory_order_relaxed);
@@ -49,9 +42,7 @@ public:
                 return;
             }
             // Wait for successor to appear
-            do {
-                succ = me.next.load(std::memory_order_acquire);
-            } while (succ == nullptr);
+            succ = busy_spin_while_equal(me.next, static_cast<Node*>(nullptr));
         }
         // Pass the lock to successor
         succ->locked.store(false, std::memory_order_release);
@@ -62,15 +53,15 @@ public:
 private:
 
 
-    struct alignas(kCacheLineSize) Node {
+    struct alignas(kCacheLine) Node {
         std::atomic<Node*> next{nullptr};
         std::atomic<bool> locked{false};
         // pad to occupy (at least) one cache line, reducing false sharing
-        char pad[kCacheLineSize - (sizeof(std::atomic<Node*>) + sizeof(std::atomic<bool>)) > 0
-                 ? kCacheLineSize - (sizeof(std::atomic<Node*>) + sizeof(std::atomic<bool>))
+        char pad[kCacheLine - (sizeof(std::atomic<Node*>) + sizeof(std::atomic<bool>)) > 0
+                 ? kCacheLine - (sizeof(std::atomic<Node*>) + sizeof(std::atomic<bool>))
                  : 1]{};
     };
-    static_assert(alignof(Node) >= kCacheLineSize, "MCS Node should be 64-byte aligned");
+    static_assert(alignof(Node) >= kCacheLine, "MCS Node should be 64-byte aligned");
 
     // One node per (lock, thread). Implemented via a thread_local map keyed by this.
     Node& node_for_this_thread() {
@@ -95,6 +86,7 @@ public:
             Node* t = tail_.load(std::memory_order_relaxed);
             if (t != nullptr) {
                 // 已有持有者/等待者，避免写入，继续观察
+                busy_wait_on(tail_, t);
                 continue;
             }
             Node* expected = nullptr;
@@ -119,14 +111,14 @@ public:
     }
 
 private:
-    struct alignas(kCacheLineSize) Node {
+    struct alignas(kCacheLine) Node {
         std::atomic<Node*> next{nullptr};
         std::atomic<bool> locked{false};
-        char pad[kCacheLineSize - (sizeof(std::atomic<Node*>) + sizeof(std::atomic<bool>)) > 0
-                 ? kCacheLineSize - (sizeof(std::atomic<Node*>) + sizeof(std::atomic<bool>))
+        char pad[kCacheLine - (sizeof(std::atomic<Node*>) + sizeof(std::atomic<bool>)) > 0
+                 ? kCacheLine - (sizeof(std::atomic<Node*>) + sizeof(std::atomic<bool>))
                  : 1]{};
     };
-    static_assert(alignof(Node) >= kCacheLineSize, "MCS Node should be 64-byte aligned");
+    static_assert(alignof(Node) >= kCacheLine, "MCS Node should be 64-byte aligned");
 
     Node& node_for_this_thread() {
         static thread_local std::unordered_map<const McsLockPreLoad*, Node> map;
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "iLock.h"
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Build-wide default of ProfiledLock: 0 = off (a plain forwarding wrapper), 1 = counts,
+// 2 = counts + wait and hold time.
+#ifndef LT_LOCK_PROFILE
+#define LT_LOCK_PROFILE 2
+#endif
+
+namespace lt {
+
+enum class ProfileLevel : int {
+    Off = 0,    // forwards to the wrapped lock, records nothing
+    Counts = 1, // acquisitions; contended ones only for locks with try_lock()
+    Timed = 2,  // plus wait time (lock() entry -> acquired) and hold time (acquired -> unlock())
+};
+
+constexpr ProfileLevel kLockProfileLevel = static_cast<ProfileLevel>(LT_LOCK_PROFILE);
+static_assert(LT_LOCK_PROFILE >= 0 && LT_LOCK_PROFILE <= 2, "LT_LOCK_PROFILE must be 0, 1 or 2");
+
+inline const char* profile_level_name(ProfileLevel l) {
+    return l == ProfileLevel::Off ? "off" : l == ProfileLevel::Counts ? "counts" : "timed";
+}
+
+// Profile totals, summed over the shards on demand. Times are in profile_ticks() units
+// (TSC ticks on x86 / the generic timer on AArch64, nanoseconds elsewhere).
+struct LockProfileCounts {
+    std::uint64_t acquisitions {0};
+    std::uint64_t contended {0};  // the fast path failed (try_lock() did, or the wait exceeded the threshold)
+    std::uint64_t waitTicks {0};
+    std::uint64_t holdTicks {0};
+};
+
+// Same clock as tsc_now() in src/tscTimer.h; unserialized, a few cycles.
+inline std::uint64_t profile_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t v;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Counters shared by a set of ProfiledLocks (one per lock class, one per service, ...),
+// sharded by thread slot: a thread only ever writes its own cache line, with plain
+// load + store (no RMW), and counts() may run at any time from any thread.
+class LockProfile {
+public:
+    // Locks without try_lock() count a lock() call as contended when it waited longer than this.
+    static constexpr std::uint64_t kDefaultContendedTicks = 1000;
+
+    explicit LockProfile(std::uint64_t contendedTicks = kDefaultContendedTicks) : contendedTicks_(contendedTicks) {}
+    LockProfile(const LockProfile&) = delete;
+    LockProfile& operator=(const LockProfile&) = delete;
+
+    LockProfileCounts counts() const {
+        LockProfileCounts sum;
+        for (const Shard& s : shards_) {
+            sum.acquisitions += s.acquisitions.load(std::memory_order_relaxed);
+            sum.contended += s.contended.load(std::memory_order_relaxed);
+            sum.waitTicks += s.waitTicks.load(std::memory_order_relaxed);
+            sum.holdTicks += s.holdTicks.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    std::uint64_t contended_ticks() const { return contendedTicks_; }
+
+private:
+    template <class L, ProfileLevel> friend class ProfiledLock;
+
+    struct alignas(kCacheLine) Shard {
+        std::atomic<std::uint64_t> acquisitions {0};
+        std::atomic<std::uint64_t> contended {0};
+        std::atomic<std::uint64_t> waitTicks {0};
+        std::atomic<std::uint64_t> holdTicks {0};
+    };
+
+    static void add(std::atomic<std::uint64_t>& c, std::uint64_t v) {
+        c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed); // single writer
+    }
+    Shard& shard() { return shards_[this_thread_slot()]; }
+
+    const std::uint64_t contendedTicks_;
+    Shard shards_[kDefaultMaxThreadSlots];
+};
+
+// Profile of the ProfiledLocks not given one of their own.
+inline LockProfile& default_lock_profile() {
+    static LockProfile profile;
+    return profile;
+}
+
+namespace detail {
+template <class L, class = void> struct HasTryLock : std::false_type {};
+template <class L>
+struct HasTryLock<L, std::void_t<decltype(static_cast<bool>(std::declval<L&>().try_lock()))>> : std::true_type {};
+} // namespace detail
+
+// Contention profiling over any iLock. Locks with try_lock() take it as the fast path and
+// count a failure as contended (no timestamps when it succeeds at Level Counts); the others
+// are timed around lock() and compared with the profile's threshold (Level Timed only). The
+// acquisition stamp lives in the wrapper and is written by the holder only.
+template <class L, ProfileLevel Level = kLockProfileLevel>
+class ProfiledLock : public iLock {
+public:
+    template <class... Args>
+    explicit ProfiledLock(LockProfile& profile, Args&&... args) : profile_(profile), inner_(std::forward<Args>(args)...) {}
+
+    void lock() override {
+        if constexpr (Level == ProfileLevel::Off) {
+            inner_.lock();
+        } else {
+            LockProfile::Shard& s = profile_.shard();
+            LockProfile::add(s.acquisitions, 1);
+            if constexpr (detail::HasTryLock<L>::value) {
+                if (inner_.try_lock()) {
+                    if constexpr (Level == ProfileLevel::Timed) acquiredAt_ = profile_ticks();
+                    return;
+                }
+                LockProfile::add(s.contended, 1);
+                if constexpr (Level == ProfileLevel::Timed) {
+                    const std::uint64_t t0 = profile_ticks();
+                    inner_.lock();
+                    acquiredAt_ = profile_ticks();
+                    LockProfile::add(s.waitTicks, acquiredAt_ - t0);
+                } else {
+                    inner_.lock();
+                }
+            } else if constexpr (Level == ProfileLevel::Timed) {
+                const std::uint64_t t0 = profile_ticks();
+                inner_.lock();
+                acquiredAt_ = profile_ticks();
+                const std::uint64_t waited = acquiredAt_ - t0;
+                LockProfile::add(s.waitTicks, waited);
+                if (waited > profile_.contendedTicks_) LockProfile::add(s.contended, 1);
+            } else {
+                inner_.lock();
+            }
+        }
+    }
+
+    void unlock() override {
+        if constexpr (Level == ProfileLevel::Timed) {
+            LockProfile::add(profile_.shard().holdTicks, profile_ticks() - acquiredAt_);
+        }
+        inner_.unlock();
+    }
+
+    L& inner() { return inner_; }
+
+private:
+    LockProfile& profile_;
+    std::uint64_t acquiredAt_ {0}; // Timed: written by the holder, read in its unlock()
+    L inner_;
+};
+
+} // namespace lt
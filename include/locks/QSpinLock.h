@@ -0,0 +1,165 @@
+#pragma once
+
+#include "iLock.h"
+#include "Backoff.h"
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <cstdint>
+
+// Test seam: runs when the queue head has seen the lock free and is about to take it
+// (tests/qspinRaceTest.cpp yields there to widen the window); empty otherwise.
+#ifndef LT_QSPIN_HEAD_HOOK
+#define LT_QSPIN_HEAD_HOOK()
+#endif
+
+namespace lt {
+
+// Queued spinlock after the Linux kernel's qspinlock: the whole lock is one 32-bit word
+//   bits  0- 7  locked byte
+//   bits  8-15  pending byte (only bit 8 is used)
+//   bits 16-17  tail index: which of the tail thread's kQSpinNesting nodes it queued with
+//   bits 18-31  tail slot + 1 (0 = empty queue)
+// Uncontended acquisition is one CAS 0 -> locked. The second contender sets pending and
+// spins on the word itself, so it needs no queue node; everyone after that queues MCS-style
+// on a node from a pool shared by all qspinlocks. Thread slots play the kernel's CPU ids and
+// each slot owns kQSpinNesting nodes, so a thread may hold that many qspinlocks at once
+// while waiting for another (the kernel's task/softirq/hardirq/nmi levels).
+constexpr int kQSpinNesting = 4;
+
+namespace detail {
+
+struct alignas(kCacheLine) QSpinNode {
+    std::atomic<QSpinNode*> next{nullptr};
+    std::atomic<int> locked{0}; // set to 1 by the predecessor when this node heads the queue
+    int count{0};               // node 0 of a slot: nodes of that slot in use (nesting depth)
+};
+
+// Per-slot queue nodes shared by every QSpinLock, like the kernel's per-CPU qnodes.
+inline QSpinNode* qspin_nodes() {
+    static QSpinNode nodes[static_cast<std::size_t>(kDefaultMaxThreadSlots) * kQSpinNesting];
+    return nodes;
+}
+
+} // namespace detail
+
+class QSpinLock : public iLock {
+public:
+    void lock() override {
+        std::uint32_t val = 0;
+        if (word_.compare_exchange_strong(val, kLocked, std::memory_order_acquire, std::memory_order_relaxed)) return;
+        lock_slow(val);
+    }
+
+    void unlock() override { word_.fetch_sub(kLocked, std::memory_order_release); }
+
+    // Succeeds only on an all-zero word, like queued_spin_trylock(): a free lock with a
+    // non-empty queue belongs to the queue head, which may be about to take it with its own
+    // CAS (or fetch_or) and must not find it taken underneath.
+    bool try_lock() {
+        std::uint32_t val = 0;
+        return word_.load(std::memory_order_relaxed) == 0 &&
+               word_.compare_exchange_strong(val, kLocked, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::uint32_t kLocked = 1u;
+    static constexpr std::uint32_t kLockedMask = 0xffu;
+    static constexpr std::uint32_t kPending = 1u << 8;
+    static constexpr std::uint32_t kPendingMask = 0xffu << 8;
+    static constexpr unsigned kTailIdxShift = 16;
+    static constexpr unsigned kTailSlotShift = 18;
+    static constexpr std::uint32_t kTailMask = 0xffffu << kTailIdxShift;
+    static constexpr unsigned kPendingLoops = 512; // waiting out a pending -> locked handover
+    static_assert(kDefaultMaxThreadSlots < (1 << (32 - kTailSlotShift)), "thread slots must fit the tail field");
+
+    static std::uint32_t encode_tail(int slot, int idx) {
+        return (static_cast<std::uint32_t>(slot + 1) << kTailSlotShift) | (static_cast<std::uint32_t>(idx) << kTailIdxShift);
+    }
+
+    static detail::QSpinNode* decode_tail(std::uint32_t tail) {
+        const std::uint32_t slot = (tail >> kTailSlotShift) - 1;
+        const std::uint32_t idx = (tail >> kTailIdxShift) & 3u;
+        return &detail::qspin_nodes()[slot * kQSpinNesting + idx];
+    }
+
+    // Replaces the tail field, keeping locked and pending; returns the previous word.
+    std::uint32_t xchg_tail(std::uint32_t tail) {
+        std::uint32_t old = word_.load(std::memory_order_relaxed);
+        while (!word_.compare_exchange_weak(old, (old & ~kTailMask) | tail, std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+        }
+        return old;
+    }
+
+    void lock_slow(std::uint32_t val) {
+        // pending is being handed over to locked right now: give it a moment to settle
+        if (val == kPending) {
+            for (unsigned n = kPendingLoops; n != 0 && val == kPending; --n) {
+                cpu_relax_once();
+                val = word_.load(std::memory_order_relaxed);
+            }
+        }
+        // only the lock holder is there: become the pending waiter
+        if ((val & ~kLockedMask) == 0) {
+            val = word_.fetch_or(kPending, std::memory_order_acquire);
+            if ((val & ~kLockedMask) == 0) {
+                for (std::uint32_t v; (v = word_.load(std::memory_order_acquire)) & kLockedMask;) wait_on(word_, v);
+                // pending -> locked in one step (pending was ours, locked is clear, tail untouched)
+                word_.fetch_add(kLocked - kPending, std::memory_order_relaxed);
+                return;
+            }
+            // lost the race to another pending waiter or a queuer: undo our bit if we set it
+            if (!(val & kPendingMask)) word_.fetch_and(~kPending, std::memory_order_relaxed);
+        }
+        queue();
+    }
+
+    void queue() {
+        const int slot = this_thread_slot(); // the pool covers every slot
+        detail::QSpinNode* base = &detail::qspin_nodes()[static_cast<std::size_t>(slot) * kQSpinNesting];
+        const int idx = base->count++;
+        if (idx >= kQSpinNesting) {
+            // deeper nesting than the pool provides: plain test-and-set spinning
+            while (!try_lock()) cpu_relax_once();
+            --base->count;
+            return;
+        }
+        detail::QSpinNode& node = base[idx];
+        node.locked.store(0, std::memory_order_relaxed);
+        node.next.store(nullptr, std::memory_order_relaxed);
+        if (try_lock()) { // the lock may have been freed while we set up
+            --base->count;
+            return;
+        }
+
+        const std::uint32_t tail = encode_tail(slot, idx);
+        const std::uint32_t old = xchg_tail(tail);
+        if (old & kTailMask) {
+            decode_tail(old & kTailMask)->next.store(&node, std::memory_order_release);
+            spin_while_equal(node.locked, 0);
+        }
+
+        // head of the queue: wait for the owner and any pending waiter to leave
+        std::uint32_t val;
+        while ((val = word_.load(std::memory_order_acquire)) & (kLockedMask | kPendingMask)) wait_on(word_, val);
+        LT_QSPIN_HEAD_HOOK();
+
+        if ((val & kTailMask) == tail) {
+            // nobody queued behind us: take the lock and empty the queue in one CAS
+            if (word_.compare_exchange_strong(val, kLocked, std::memory_order_acquire, std::memory_order_relaxed)) {
+                --base->count;
+                return;
+            }
+        }
+        // a successor exists (or just arrived): set locked, then pass the head to it
+        word_.fetch_or(kLocked, std::memory_order_acquire);
+        detail::QSpinNode* next = spin_while_equal(node.next, static_cast<detail::QSpinNode*>(nullptr));
+        next->locked.store(1, std::memory_order_release);
+        --base->count;
+    }
+
+    std::atomic<std::uint32_t> word_{0};
+};
+
+} // namespace lt
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "iRWLock.h"
+#include "Backoff.h"
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+
+namespace lt {
+
+// std::shared_mutex as the library baseline
+class SharedMutexRWLock : public iRWLock {
+public:
+    void lock() override { m_.lock(); }
+    void unlock() override { m_.unlock(); }
+    void lock_shared() override { m_.lock_shared(); }
+    void unlock_shared() override { m_.unlock_shared(); }
+
+private:
+    std::shared_mutex m_;
+};
+
+// Centralized counter RW spinlock: one word, top bit = writer, low bits = reader count.
+// Both sides observe before they CAS; no writer preference, so writers can starve.
+class CentralRWSpinlock : public iRWLock {
+public:
+    void lock() override {
+        for (;;) {
+            if (state_.load(std::memory_order_relaxed) != 0) {
+                cpu_relax_once();
+                continue;
+            }
+            std::uint32_t expected = 0;
+            if (state_.compare_exchange_weak(expected, kWriter, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    void unlock() override { state_.store(0, std::memory_order_release); }
+
+    void lock_shared() override {
+        for (;;) {
+            std::uint32_t v = state_.load(std::memory_order_relaxed);
+            if (v & kWriter) {
+                cpu_relax_once();
+                continue;
+            }
+            if (state_.compare_exchange_weak(v, v + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    void unlock_shared() override { state_.fetch_sub(1, std::memory_order_release); }
+
+private:
+    static constexpr std::uint32_t kWriter = 1u << 31;
+    alignas(kCacheLine) std::atomic<std::uint32_t> state_{0};
+};
+
+// Distributed "big reader" lock: each reader only writes its own cache-line flag (indexed
+// by this_thread_slot(), i.e. per pinned CPU in the harness), so read acquisition never
+// bounces a shared line. A writer takes the writer flag and waits for every reader flag
+// to drain, which makes writes O(threads).
+class BigReaderRWLock : public iRWLock {
+public:
+    explicit BigReaderRWLock(int maxThreads = kDefaultMaxThreadSlots)
+        : capacity_(maxThreads > 0 ? maxThreads : 1), readers_(new ReaderFlag[static_cast<std::size_t>(capacity_)]) {}
+
+    void lock() override {
+        while (writer_.exchange(true, std::memory_order_seq_cst)) {
+            spin_while_equal(writer_, true, std::memory_order_relaxed);
+        }
+        // seq_cst pairs with the reader's flag store / writer load (Dekker-style handshake)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (int i = 0; i < capacity_; ++i) {
+            spin_while_equal(readers_[static_cast<std::size_t>(i)].active, true);
+        }
+    }
+
+    void unlock() override { writer_.store(false, std::memory_order_release); }
+
+    void lock_shared() override {
+        ReaderFlag& me = flag_for_this_thread();
+        for (;;) {
+            me.active.store(true, std::memory_order_seq_cst);
+            if (!writer_.load(std::memory_order_seq_cst)) return;
+            // a writer is in or entering: step back and wait for it to finish
+            me.active.store(false, std::memory_order_release);
+            spin_while_equal(writer_, true, std::memory_order_relaxed);
+        }
+    }
+
+    void unlock_shared() override { flag_for_this_thread().active.store(false, std::memory_order_release); }
+
+private:
+    struct alignas(kCacheLine) ReaderFlag {
+        std::atomic<bool> active{false};
+    };
+
+    ReaderFlag& flag_for_this_thread() {
+        const int slot = checked_thread_slot(capacity_, "BigReaderRWLock");
+        return readers_[static_cast<std::size_t>(slot)];
+    }
+
+    const int capacity_;
+    std::unique_ptr<ReaderFlag[]> readers_;
+    alignas(kCacheLine) std::atomic<bool> writer_{false};
+};
+
+// Phase-fair ticket RW lock (PF-T, Brandenburg & Anderson 2009). Readers and writers
+// alternate in phases: a reader waits for at most one writer phase, a writer for at most
+// one reader phase; writers are FIFO among themselves via a ticket pair.
+class PhaseFairRWLock : public iRWLock {
+public:
+    void lock() override {
+        // FIFO among writers
+        const std::uint32_t ticket = win_.fetch_add(1, std::memory_order_relaxed);
+        for (std::uint32_t s; (s = wout_.load(std::memory_order_acquire)) != ticket;) wait_on(wout_, s);
+        // block new readers, then wait for the readers already inside to leave
+        const std::uint32_t w = kPresent | (ticket & kPhaseId);
+        const std::uint32_t readersIn = rin_.fetch_add(w, std::memory_order_acq_rel);
+        for (std::uint32_t s; (s = rout_.load(std::memory_order_acquire)) != readersIn;) wait_on(rout_, s);
+    }
+
+    void unlock() override {
+        rin_.fetch_and(~kWriterBits, std::memory_order_release);
+        wout_.fetch_add(1, std::memory_order_release);
+    }
+
+    void lock_shared() override {
+        const std::uint32_t w = rin_.fetch_add(kReaderInc, std::memory_order_acquire) & kWriterBits;
+        if (w != 0) {
+            // a writer is present: wait until its phase ends (writer bits change)
+            while ((rin_.load(std::memory_order_acquire) & kWriterBits) == w) cpu_relax_once();
+        }
+    }
+
+    void unlock_shared() override { rout_.fetch_add(kReaderInc, std::memory_order_release); }
+
+private:
+    static constexpr std::uint32_t kReaderInc = 0x100; // reader counts live above the writer byte
+    static constexpr std::uint32_t kWriterBits = 0x3;
+    static constexpr std::uint32_t kPresent = 0x2;     // a writer is present
+    static constexpr std::uint32_t kPhaseId = 0x1;     // distinguishes consecutive writer phases
+
+    alignas(kCacheLine) std::atomic<std::uint32_t> rin_{0};
+    alignas(kCacheLine) std::atomic<std::uint32_t> rout_{0};
+    alignas(kCacheLine) std::atomic<std::uint32_t> win_{0};
+    alignas(kCacheLine) std::atomic<std::uint32_t> wout_{0};
+};
+
+} // namespace lt
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "iLock.h"
+#include "Backoff.h"
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <cstdint>
+#include <pthread.h>
+
+namespace lt {
+
+// Locks for the cross-process mode: the whole state lives inside the object (no pointers,
+// no heap node arrays, no process-local tables), so an instance placed in a shared mapping
+// works between processes. The lock words hold no addresses, so the mapping may sit at a
+// different address in each process; the vtable pointer does assume the harness's forked
+// workers, which share the executable's layout.
+
+// MCS lock with its queue nodes stored inline, one per thread slot, and linked by slot
+// index + 1 instead of by address (0 = none). The harness gives every worker process a
+// distinct slot. Same algorithm as McsSlotLock; the inline array costs 64 B per slot.
+class ShmMcsLock : public iLock {
+public:
+    static constexpr int kCapacity = kDefaultMaxThreadSlots;
+
+    void lock() override {
+        const std::uint32_t me = self();
+        Node& node = nodes_[me - 1];
+        node.next.store(0, std::memory_order_relaxed);
+        node.locked.store(1, std::memory_order_relaxed);
+
+        const std::uint32_t prev = tail_.exchange(me, std::memory_order_acq_rel);
+        if (prev != 0) {
+            nodes_[prev - 1].next.store(me, std::memory_order_release);
+            spin_while_equal(node.locked, 1u);
+        }
+    }
+
+    void unlock() override {
+        const std::uint32_t me = self();
+        Node& node = nodes_[me - 1];
+        std::uint32_t succ = node.next.load(std::memory_order_acquire);
+        if (succ == 0) {
+            std::uint32_t expected = me;
+            if (tail_.compare_exchange_strong(expected, 0, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return;
+            }
+            succ = busy_spin_while_equal(node.next, 0u);
+        }
+        nodes_[succ - 1].locked.store(0, std::memory_order_release);
+    }
+
+private:
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "shared lock words must be lock-free");
+
+    struct alignas(kCacheLine) Node {
+        std::atomic<std::uint32_t> next{0};   // successor slot + 1
+        std::atomic<std::uint32_t> locked{0};
+    };
+
+    static std::uint32_t self() {
+        const int slot = this_thread_slot(); // kCapacity covers every slot
+        return static_cast<std::uint32_t>(slot) + 1;
+    }
+
+    alignas(kCacheLine) std::atomic<std::uint32_t> tail_{0}; // last queued slot + 1
+    Node nodes_[kCapacity];
+};
+
+// pthread mutex with PTHREAD_PROCESS_SHARED (glibc then uses non-private futexes).
+class PSharedMutexLock : public iLock {
+public:
+    PSharedMutexLock() {
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutex_init(&m_, &attr);
+        pthread_mutexattr_destroy(&attr);
+    }
+    ~PSharedMutexLock() override { pthread_mutex_destroy(&m_); }
+    PSharedMutexLock(const PSharedMutexLock&) = delete;
+    PSharedMutexLock& operator=(const PSharedMutexLock&) = delete;
+
+    void lock() override { pthread_mutex_lock(&m_); }
+    void unlock() override { pthread_mutex_unlock(&m_); }
+
+private:
+    pthread_mutex_t m_;
+};
+
+} // namespace lt
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "iLock.h"
+#include "SpinWait.h"
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace lt {
+
+// MCS lock whose queue nodes live in a preallocated, cache-aligned array indexed by
+// this_thread_slot(). Same algorithm as McsLock minus the per-call hash map lookup.
+class McsSlotLock : public iLock {
+public:
+    explicit McsSlotLock(int maxThreads = kDefaultMaxThreadSlots)
+        : capacity_(maxThreads > 0 ? maxThreads : 1), nodes_(new Node[static_cast<std::size_t>(capacity_)]) {}
+
+    void lock() override {
+        Node& me = node_for_this_thread();
+        me.next.store(nullptr, std::memory_order_relaxed);
+        me.locked.store(true, std::memory_order_relaxed);
+
+        Node* prev = tail_.exchange(&me, std::memory_order_acq_rel);
+        if (prev != nullptr) {
+            prev->next.store(&me, std::memory_order_release);
+            busy_spin_while_equal(me.locked, true);
+        }
+    }
+
+    void unlock() override {
+        Node& me = node_for_this_thread();
+        Node* succ = me.next.load(std::memory_order_acquire);
+        if (succ == nullptr) {
+            Node* expected = &me;
+            if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return;
+            }
+            succ = busy_spin_while_equal(me.next, static_cast<Node*>(nullptr));
+        }
+        succ->locked.store(false, std::memory_order_release);
+    }
+
+private:
+    struct alignas(kCacheLine) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool> locked{false};
+    };
+
+    Node& node_for_this_thread() {
+        const int slot = checked_thread_slot(capacity_, "McsSlotLock");
+        return nodes_[static_cast<std::size_t>(slot)];
+    }
+
+    const int capacity_;
+    std::unique_ptr<Node[]> nodes_;
+    alignas(kCacheLine) std::atomic<Node*> tail_{nullptr};
+};
+
+// CLH queue lock on the same slot infrastructure: each waiter spins on its predecessor's
+// node and, on release, adopts that node for its next acquisition (nodes migrate between
+// threads, so the pool holds one extra node for the initial tail).
+class ClhLock : public iLock {
+public:
+    explicit ClhLock(int maxThreads = kDefaultMaxThreadSlots)
+        : capacity_(maxThreads > 0 ? maxThreads : 1),
+          nodes_(new Node[static_cast<std::size_t>(capacity_) + 1]),
+          slots_(new Slot[static_cast<std::size_t>(capacity_)]) {
+        for (int i = 0; i < capacity_; ++i) {
+            slots_[static_cast<std::size_t>(i)].mine = &nodes_[static_cast<std::size_t>(i)];
+        }
+        tail_.store(&nodes_[static_cast<std::size_t>(capacity_)], std::memory_order_relaxed); // unlocked dummy
+    }
+
+    void lock() override {
+        Slot& s = slot_for_this_thread();
+        s.mine->locked.store(true, std::memory_order_relaxed);
+        Node* pred = tail_.exchange(s.mine, std::memory_order_acq_rel);
+        s.pred = pred;
+        busy_spin_while_equal(pred->locked, true); // wait on predecessor's node
+    }
+
+    void unlock() override {
+        Slot& s = slot_for_this_thread();
+        Node* mine = s.mine;
+        s.mine = s.pred; // predecessor's node is free now; reuse it next time
+        mine->locked.store(false, std::memory_order_release);
+    }
+
+private:
+    struct alignas(kCacheLine) Node {
+        std::atomic<bool> locked{false};
+    };
+
+    // Per-thread CLH state, only touched by its owning thread
+    struct alignas(kCacheLine) Slot {
+        Node* mine{nullptr};
+        Node* pred{nullptr};
+    };
+
+    Slot& slot_for_this_thread() {
+        const int slot = checked_thread_slot(capacity_, "ClhLock");
+        return slots_[static_cast<std::size_t>(slot)];
+    }
+
+    const int capacity_;
+    std::unique_ptr<Node[]> nodes_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(kCacheLine) std::atomic<Node*> tail_{nullptr};
+};
+
+} // namespace lt
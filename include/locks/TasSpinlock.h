@@ -1,18 +1,21 @@
 #pragma once
 
 #include "iLock.h"
+#include "Backoff.h"
 #include <atomic>
 
 namespace lt {
 
-// 原版 TAS 自旋锁：使用 atomic_flag 的 test_and_set
-class TasSpinlock : public iLock {
+// 原版 TAS 自旋锁：使用 atomic_flag 的 test_and_set；Backoff 为每次失败后的退避策略（见 Backoff.h）
+template <class Backoff = NoBackoff>
+class BasicTasSpinlock : public iLock, private BackoffStore<Backoff> {
 public:
-    TasSpinlock() = default;
+    explicit BasicTasSpinlock(BackoffParams params = {}) : BackoffStore<Backoff>(params) {}
 
     void lock() override {
+        Backoff bo(this->backoff_params());
         while (flag_.test_and_set(std::memory_order_acquire)) {
-            // busy-wait
+            bo.pause(1); // busy-wait
         }
     }
 
@@ -26,13 +29,17 @@ private:
 
 // 预观测版 TAS：先 load 观察，再 CAS 抢占，避免在已锁状态下进行原子写（RFO）
 // state_: 0 = unlocked, 1 = locked
-class TasSpinlockPreLoad : public iLock {
+template <class Backoff = NoBackoff>
+class BasicTasSpinlockPreLoad : public iLock, private BackoffStore<Backoff> {
 public:
-    TasSpinlockPreLoad() = default;
+    explicit BasicTasSpinlockPreLoad(BackoffParams params = {}) : BackoffStore<Backoff>(params) {}
 
     void lock() override {
+        Backoff bo(this->backoff_params());
         for (;;) {
-            if (state_.load(std::memory_order_relaxed) != 0) {
+            const int seen = state_.load(std::memory_order_relaxed);
+            if (seen != 0) {
+                backoff_wait(bo, state_, seen, 1);
                 continue; // 已被占用，避免 RMW，继续自旋观察
             }
             int expected = 0;
@@ -41,6 +48,7 @@ public:
                                              std::memory_order_relaxed)) {
                 return;
             }
+            bo.pause(1);
         }
     }
 
@@ -52,4 +60,7 @@ private:
     std::atomic<int> state_{0};
 };
 
+using TasSpinlock = BasicTasSpinlock<NoBackoff>;
+using TasSpinlockPreLoad = BasicTasSpinlockPreLoad<NoBackoff>;
+
 } // namespace lt
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "iRunTask.h"
+#include "ThreadSlot.h"
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace lt {
+
+// Heterogeneous workload: worker slot s runs tasks[groupOf[s]], so thread groups get their own
+// task kind and parallel/locked sizes under one shared lock. Every call costs one extra
+// indirection (slot -> group task), the same for all groups. Critical sections are executed
+// by the acquiring thread, so this does not combine with delegation locks, whose combiner or
+// server runs other threads' sections.
+class GroupTask : public iRunTask {
+public:
+    GroupTask(std::vector<std::unique_ptr<iRunTask>> tasks, std::vector<int> groupOf)
+        : tasks_(std::move(tasks)), groupOf_(std::move(groupOf)) {
+        for (int g : groupOf_) {
+            assert(g >= 0 && static_cast<std::size_t>(g) < tasks_.size() && "group id without a task");
+            (void)g;
+        }
+    }
+
+    void reset() override {
+        for (auto& t : tasks_) t->reset();
+    }
+    void prepare_thread() override { mine()->prepare_thread(); }
+    void run_parallel() override { mine()->run_parallel(); }
+    void run_locked() override { mine()->run_locked(); }
+    void run_locked_read() override { mine()->run_locked_read(); }
+    void run_locked_stripe(int stripe) override { mine()->run_locked_stripe(stripe); }
+    const char* name() const override { return "group"; }
+
+private:
+    inline iRunTask* mine() const {
+        const int slot = checked_thread_slot(static_cast<int>(groupOf_.size()), "GroupTask");
+        return tasks_[static_cast<std::size_t>(groupOf_[static_cast<std::size_t>(slot)])].get();
+    }
+
+    std::vector<std::unique_ptr<iRunTask>> tasks_;
+    std::vector<int> groupOf_; // indexed by worker slot
+};
+
+} // namespace lt
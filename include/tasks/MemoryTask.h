@@ -0,0 +1,116 @@
+#pragma once
+
+#include "iRunTask.h"
+#include "ThreadArena.h"
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace lt {
+
+// Access pattern of BasicMemoryTask::run_parallel().
+enum class MemoryPattern {
+    Stream, // sequential read-modify-write of consecutive lines: bandwidth bound, prefetch friendly
+    Chase,  // dependent loads along a random cyclic permutation of lines: latency bound
+};
+
+// Non-critical work that is memory- rather than ALU-bound. Each thread owns a `bufferBytes`
+// buffer from a ThreadArena (size picks L1 / L2 / LLC / DRAM residency); every run_parallel()
+// touches `linesPerRun` cache lines of it, continuing where the previous call stopped, so the
+// cost per iteration is fixed while the footprint decides where the lines come from. The
+// critical section is `lockedIters` rounds of cpu_burn's scramble (no shared state, so the
+// striped loop's default run_locked_stripe() is fine).
+template <MemoryPattern P>
+class BasicMemoryTask : public iRunTask {
+public:
+    BasicMemoryTask(std::size_t bufferBytes, int linesPerRun, int lockedIters, bool hugePages,
+                    int maxThreads = kDefaultMaxThreadSlots)
+        : lines_(bufferBytes / kCacheLine > 0 ? bufferBytes / kCacheLine : 1),
+          linesPerRun_(linesPerRun > 0 ? static_cast<std::size_t>(linesPerRun) : 1),
+          lockedIters_(lockedIters),
+          maxThreads_(maxThreads > 0 ? maxThreads : 1),
+          arena_(maxThreads_, lines_ * kCacheLine, hugePages),
+          cursors_(new Cursor[static_cast<std::size_t>(maxThreads_)]) {}
+
+    void reset() override {
+        // buffers keep their contents (and the Chase links) across runs
+    }
+
+    // Maps and first-touches this worker's buffer on its own CPU; Chase also links the lines.
+    void prepare_thread() override {
+        const int slot = checked_thread_slot(maxThreads_, "memory task");
+        if (arena_.get(slot) != nullptr) return;
+        Line* buf = reinterpret_cast<Line*>(arena_.local());
+        if constexpr (P == MemoryPattern::Chase) link_random_cycle(buf, static_cast<std::uint64_t>(slot));
+        cursors_[slot].pos = 0;
+    }
+
+    void run_parallel() override {
+        Cursor& c = cursors_[this_thread_slot()];
+        Line* buf = reinterpret_cast<Line*>(arena_.get(this_thread_slot()));
+        std::size_t pos = c.pos;
+        if constexpr (P == MemoryPattern::Stream) {
+            for (std::size_t i = 0; i < linesPerRun_; ++i) {
+                buf[pos].v[0] += 1;
+                if (++pos == lines_) pos = 0;
+            }
+        } else {
+            for (std::size_t i = 0; i < linesPerRun_; ++i) pos = static_cast<std::size_t>(buf[pos].v[0]);
+        }
+        c.pos = pos;
+    }
+
+    void run_locked() override {
+        volatile std::uint64_t x = 0x9e3779b97f4a7c15ULL;
+        for (int i = 0; i < lockedIters_; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+        (void)x;
+    }
+
+    const char* name() const override { return P == MemoryPattern::Stream ? "mem_stream" : "mem_chase"; }
+
+    ArenaPages pages(int slot) const { return arena_.pages(slot); }
+
+private:
+    struct alignas(kCacheLine) Line {
+        std::uint64_t v[kCacheLine / sizeof(std::uint64_t)]{};
+    };
+    struct alignas(kCacheLine) Cursor {
+        std::size_t pos {0};
+    };
+
+    // Links the lines in a random (Fisher-Yates) order closed into one cycle, so the walk
+    // visits every line before repeating and the prefetcher cannot guess the next one.
+    void link_random_cycle(Line* buf, std::uint64_t seed) const {
+        std::unique_ptr<std::uint32_t[]> order(new std::uint32_t[lines_]);
+        for (std::size_t i = 0; i < lines_; ++i) order[i] = static_cast<std::uint32_t>(i);
+        std::uint64_t s = 0x2545f4914f6cdd1dULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+        for (std::size_t i = lines_ - 1; i > 0; --i) {
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            const std::size_t j = static_cast<std::size_t>(s % (i + 1));
+            const std::uint32_t t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+        }
+        for (std::size_t i = 0; i < lines_; ++i) buf[order[i]].v[0] = order[(i + 1) % lines_];
+    }
+
+    const std::size_t lines_;
+    const std::size_t linesPerRun_;
+    const int lockedIters_;
+    const int maxThreads_;
+    ThreadArena arena_;
+    std::unique_ptr<Cursor[]> cursors_;
+};
+
+using MemStreamTask = BasicMemoryTask<MemoryPattern::Stream>;
+using MemChaseTask = BasicMemoryTask<MemoryPattern::Chase>;
+
+} // namespace lt
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "iRunTask.h"
+#include "ThreadArena.h"
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace lt {
+
+// A task whose critical section reads and writes `sharedLines` shared cache lines, so every
+// lock handover also migrates the protected data to the new owner. run_parallel() does a
+// read-modify-write pass over a private working set of `privateBytes` per thread (a
+// ThreadArena buffer of this_thread_slot(), first-touched by the pinned worker in
+// prepare_thread()), which competes with the shared lines for the owner's cache.
+// With `stripes` > 1 every lock stripe protects its own group of `sharedLines` lines.
+// sharedStorage, if given, holds the shared lines instead of the heap (shared_bytes() bytes,
+// cache-line aligned), e.g. inside the mapping the lock lives in for the cross-process mode;
+// the private working sets stay process-local.
+class SharedDataTask : public iRunTask {
+public:
+    SharedDataTask(int sharedLines = 4, std::size_t privateBytes = 4096, int maxThreads = kDefaultMaxThreadSlots,
+                   int stripes = 1, std::shared_ptr<void> sharedStorage = nullptr)
+        : sharedLines_(sharedLines > 0 ? static_cast<std::size_t>(sharedLines) : 1),
+          privateLines_(privateBytes / kCacheLine),
+          maxThreads_(maxThreads > 0 ? maxThreads : 1),
+          stripes_(stripes > 0 ? static_cast<std::size_t>(stripes) : 1),
+          sharedStorage_(sharedStorage ? std::move(sharedStorage)
+                                       : std::shared_ptr<void>(new Line[sharedLines_ * stripes_], std::default_delete<Line[]>())),
+          shared_(static_cast<Line*>(sharedStorage_.get())),
+          private_(maxThreads_, privateLines_ * kCacheLine, false) {
+        std::uninitialized_default_construct_n(shared_, sharedLines_ * stripes_);
+        reset();
+    }
+
+    static std::size_t shared_bytes(int sharedLines, int stripes) {
+        return static_cast<std::size_t>(sharedLines > 0 ? sharedLines : 1) * static_cast<std::size_t>(stripes > 0 ? stripes : 1) *
+               sizeof(Line);
+    }
+
+    void reset() override {
+        for (std::size_t i = 0; i < sharedLines_ * stripes_; ++i) shared_[i] = Line{};
+        // only slots whose owner already mapped its buffer; the rest are zero-filled on first touch
+        for (int s = 0; s < maxThreads_; ++s) {
+            if (unsigned char* p = private_.get(s)) std::memset(p, 0, privateLines_ * kCacheLine);
+        }
+    }
+
+    // Maps and zero-fills this worker's private lines on its own CPU (NUMA first touch).
+    void prepare_thread() override { (void)private_.local(); }
+
+    void run_parallel() override {
+        const int slot = checked_thread_slot(maxThreads_, "SharedDataTask");
+        Line* mine = reinterpret_cast<Line*>(private_.get(slot));
+        for (std::size_t i = 0; i < privateLines_; ++i) {
+            mine[i].v[0] += 1;
+        }
+    }
+
+    void run_locked() override { write_group(0); }
+
+    void run_locked_stripe(int stripe) override {
+        assert(static_cast<std::size_t>(stripe) < stripes_ && "stripe exceeds SharedDataTask stripes");
+        write_group(static_cast<std::size_t>(stripe));
+    }
+
+    // Reader side: load the shared lines without writing them
+    void run_locked_read() override {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < sharedLines_; ++i) {
+            sum += shared_[i].v[0];
+        }
+        keep_alive(sum);
+    }
+
+    const char* name() const override { return "shared_data"; }
+
+    // Completed critical sections since reset(); must equal the op count if the lock is correct.
+    std::uint64_t locked_count() const {
+        std::uint64_t n = 0;
+        for (std::size_t s = 0; s < stripes_; ++s) n += shared_[sharedLines_ * s].v[0];
+        return n;
+    }
+
+private:
+    struct alignas(kCacheLine) Line {
+        std::uint64_t v[kCacheLine / sizeof(std::uint64_t)]{};
+    };
+
+    const std::size_t sharedLines_;
+    const std::size_t privateLines_;
+    const int maxThreads_;
+    const std::size_t stripes_;
+    std::shared_ptr<void> sharedStorage_;
+    Line* shared_;
+    ThreadArena private_;
+
+    inline void write_group(std::size_t stripe) {
+        Line* group = &shared_[sharedLines_ * stripe];
+        for (std::size_t i = 0; i < sharedLines_; ++i) {
+            group[i].v[0] += 1;
+        }
+    }
+
+    // Keeps the reader loads from being optimized away without writing shared memory
+    static inline void keep_alive(std::uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r"(v));
+#else
+        static thread_local volatile std::uint64_t sink;
+        sink = v;
+#endif
+    }
+};
+
+} // namespace lt
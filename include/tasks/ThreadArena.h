@@ -0,0 +1,114 @@
+#pragma once
+
+#include "ThreadSlot.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace lt {
+
+// How a ThreadArena buffer is backed.
+enum class ArenaPages {
+    Normal,      // regular 4 KiB pages
+    HugeTlb,     // MAP_HUGETLB (needs reserved pages: /proc/sys/vm/nr_hugepages)
+    Transparent, // huge pages requested but MAP_HUGETLB failed: madvise(MADV_HUGEPAGE)
+};
+
+constexpr std::size_t kArenaHugePage = std::size_t{2} << 20;
+
+// One private buffer of `bytes` per thread slot. A buffer is mapped and first-touched by the
+// thread that owns the slot (local(), called from iRunTask::prepare_thread() after the worker
+// is pinned), so the kernel's first-touch policy places its pages on that worker's NUMA node.
+// The same slot keeps its buffer across runs; pooled workers keep their CPU, so it stays local.
+class ThreadArena {
+public:
+    ThreadArena(int maxThreads, std::size_t bytes, bool hugePages)
+        : maxThreads_(maxThreads > 0 ? maxThreads : 1),
+          bytes_(bytes > 0 ? bytes : 1),
+          hugePages_(hugePages),
+          buffers_(new Buffer[static_cast<std::size_t>(maxThreads_)]) {}
+
+    ~ThreadArena() {
+        for (int i = 0; i < maxThreads_; ++i) release(buffers_[i]);
+    }
+
+    ThreadArena(const ThreadArena&) = delete;
+    ThreadArena& operator=(const ThreadArena&) = delete;
+
+    // Buffer of the calling thread's slot, mapped and zero-filled on first use.
+    unsigned char* local() {
+        const int slot = checked_thread_slot(maxThreads_, "ThreadArena");
+        Buffer& b = buffers_[slot];
+        if (b.data == nullptr) acquire(b);
+        return b.data;
+    }
+
+    // Buffer of `slot`, nullptr until its owner has called local().
+    unsigned char* get(int slot) const { return buffers_[slot].data; }
+    ArenaPages pages(int slot) const { return buffers_[slot].pages; }
+    std::size_t bytes() const { return bytes_; }
+
+private:
+    struct alignas(kCacheLine) Buffer {
+        unsigned char* data {nullptr};
+        std::size_t mapped {0};
+        ArenaPages pages {ArenaPages::Normal};
+    };
+
+    void acquire(Buffer& b) {
+#if defined(__linux__)
+        const std::size_t len = hugePages_ ? (bytes_ + kArenaHugePage - 1) / kArenaHugePage * kArenaHugePage : bytes_;
+        void* p = MAP_FAILED;
+        if (hugePages_) {
+            p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            b.pages = ArenaPages::HugeTlb;
+        }
+        if (p == MAP_FAILED) {
+            p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            b.pages = ArenaPages::Normal;
+            if (p != MAP_FAILED && hugePages_) {
+                (void)madvise(p, len, MADV_HUGEPAGE);
+                b.pages = ArenaPages::Transparent;
+                warn_no_hugetlb();
+            }
+        }
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        b.data = static_cast<unsigned char*>(p);
+        b.mapped = len;
+#else
+        b.data = static_cast<unsigned char*>(::operator new(bytes_, std::align_val_t(kCacheLine)));
+        b.mapped = bytes_;
+#endif
+        std::memset(b.data, 0, bytes_); // first touch from the owning CPU
+    }
+
+    static void release(Buffer& b) {
+        if (b.data == nullptr) return;
+#if defined(__linux__)
+        munmap(b.data, b.mapped);
+#else
+        ::operator delete(b.data, std::align_val_t(kCacheLine));
+#endif
+        b.data = nullptr;
+    }
+
+    static void warn_no_hugetlb() {
+        static std::atomic<bool> warned{false};
+        if (warned.exchange(true, std::memory_order_relaxed)) return;
+        std::fprintf(stderr, "MAP_HUGETLB failed (no reserved huge pages?); using transparent huge pages\n");
+    }
+
+    const int maxThreads_;
+    const std::size_t bytes_;
+    const bool hugePages_;
+    std::unique_ptr<Buffer[]> buffers_;
+};
+
+} // namespace lt
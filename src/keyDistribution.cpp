@@ -0,0 +1,66 @@
+#include "keyDistribution.h"
+
+#include <cmath>
+#include <sstream>
+
+namespace lt {
+
+bool parse_key_spec(const std::string& text, KeySpec& out, std::string& err) {
+    KeySpec k;
+    k.spec = text;
+    std::stringstream ss(text);
+    std::string kind, a, b;
+    std::getline(ss, kind, ':');
+    const bool haveA = static_cast<bool>(std::getline(ss, a, ':'));
+    const bool haveB = static_cast<bool>(std::getline(ss, b, ':'));
+    try {
+        if (kind == "uniform") {
+            k.dist = KeyDist::Uniform;
+            if (haveA) {
+                err = "key distribution 'uniform' takes no arguments";
+                return false;
+            }
+        } else if (kind == "zipf") {
+            k.dist = KeyDist::Zipf;
+            k.param = haveA ? std::stod(a) : 0.99;
+            if (k.param < 0.0 || haveB) {
+                err = "zipf needs one exponent >= 0, e.g. zipf:0.99";
+                return false;
+            }
+        } else if (kind == "hotspot") {
+            k.dist = KeyDist::Hotspot;
+            k.param = haveA ? std::stod(a) : 0.9;
+            k.hot = haveB ? std::stoi(b) : 1;
+            if (k.param < 0.0 || k.param > 1.0 || k.hot < 1) {
+                err = "hotspot needs a probability in [0, 1] and a hot set size >= 1, e.g. hotspot:0.9:1";
+                return false;
+            }
+        } else {
+            err = "unknown key distribution '" + text + "', supported: uniform, zipf:<s>, hotspot:<p>[:<h>]";
+            return false;
+        }
+    } catch (...) {
+        err = "malformed key distribution '" + text + "'";
+        return false;
+    }
+    out = k;
+    return true;
+}
+
+KeyTable::KeyTable(const KeySpec& spec, int stripes)
+    : dist_(spec.dist), stripes_(stripes > 0 ? stripes : 1), hot_(std::min(std::max(spec.hot, 1), stripes_)) {
+    if (dist_ == KeyDist::Hotspot) {
+        hotThreshold_ = static_cast<std::uint64_t>(spec.param * 4294967296.0);
+    } else if (dist_ == KeyDist::Zipf) {
+        double norm = 0.0;
+        for (int k = 0; k < stripes_; ++k) norm += 1.0 / std::pow(k + 1.0, spec.param);
+        cdf_.resize(static_cast<std::size_t>(stripes_));
+        double acc = 0.0;
+        for (int k = 0; k < stripes_; ++k) {
+            acc += 1.0 / std::pow(k + 1.0, spec.param) / norm;
+            cdf_[static_cast<std::size_t>(k)] = static_cast<std::uint32_t>(std::min(acc * 4294967296.0, 4294967295.0));
+        }
+    }
+}
+
+} // namespace lt
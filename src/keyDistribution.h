@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lt {
+
+// How the striped loop picks one of K stripes per iteration.
+enum class KeyDist {
+    Uniform, // "uniform": every stripe equally likely
+    Zipf,    // "zipf:<s>": P(stripe k) ~ 1 / (k + 1)^s
+    Hotspot, // "hotspot:<p>[:<h>]": probability p for the first h stripes (default 1), else uniform
+};
+
+struct KeySpec {
+    KeyDist dist {KeyDist::Uniform};
+    double param {0.0}; // zipf exponent s, or hotspot probability p
+    int hot {1};        // hotspot: size of the hot set
+    std::string spec {"uniform"}; // original text, for reports
+};
+
+// Parses a --keys value; on failure returns false and sets err.
+bool parse_key_spec(const std::string& text, KeySpec& out, std::string& err);
+
+// Read-only sampling table for one run, built before the window and shared by all workers.
+// pick() maps a 64-bit random value (from the worker's own PRNG) to a stripe in [0, K).
+class KeyTable {
+public:
+    KeyTable(const KeySpec& spec, int stripes);
+
+    int stripes() const { return stripes_; }
+
+    inline int pick(std::uint64_t r) const {
+        const std::uint64_t hi = r >> 32, lo = r & 0xffffffffu;
+        switch (dist_) {
+        case KeyDist::Uniform:
+            return static_cast<int>((hi * static_cast<std::uint64_t>(stripes_)) >> 32);
+        case KeyDist::Zipf: {
+            // cdf_[k] = P(stripe <= k) scaled to 2^32
+            auto it = std::upper_bound(cdf_.begin(), cdf_.end(), static_cast<std::uint32_t>(hi));
+            return std::min(static_cast<int>(it - cdf_.begin()), stripes_ - 1);
+        }
+        case KeyDist::Hotspot:
+            if (hi < hotThreshold_) return static_cast<int>((lo * static_cast<std::uint64_t>(hot_)) >> 32);
+            return static_cast<int>((lo * static_cast<std::uint64_t>(stripes_)) >> 32);
+        }
+        return 0;
+    }
+
+private:
+    KeyDist dist_;
+    int stripes_;
+    int hot_;
+    std::uint64_t hotThreshold_ {0};
+    std::vector<std::uint32_t> cdf_;
+};
+
+} // namespace lt
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CacheLine.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace lt {
+
+// Log-linear (HDR-style) histogram of nanosecond latencies.
+// Values below 2^(kSubBits+1) are recorded exactly; above that every power-of-two range
+// is split into 2^kSubBits linear sub-buckets, i.e. ~3% relative error with kSubBits=5.
+// Storage is a fixed array: record() never allocates, so it is safe on the hot path.
+class alignas(kCacheLine) LatencyHistogram {
+public:
+    static constexpr unsigned kSubBits = 5;
+    static constexpr std::uint64_t kSubCount = 1ull << kSubBits;
+    static constexpr std::size_t kBuckets = (64 - kSubBits + 1) * kSubCount;
+
+    LatencyHistogram() { reset(); }
+
+    void reset() {
+        std::fill(counts_, counts_ + kBuckets, 0);
+        total_ = 0;
+        sum_ = 0;
+        min_ = UINT64_MAX;
+        max_ = 0;
+    }
+
+    inline void record(std::uint64_t ns) {
+        ++counts_[bucket_of(ns)];
+        ++total_;
+        sum_ += ns;
+        if (ns < min_) min_ = ns;
+        if (ns > max_) max_ = ns;
+    }
+
+    void merge(const LatencyHistogram& o) {
+        for (std::size_t i = 0; i < kBuckets; ++i) counts_[i] += o.counts_[i];
+        total_ += o.total_;
+        sum_ += o.sum_;
+        min_ = std::min(min_, o.min_);
+        max_ = std::max(max_, o.max_);
+    }
+
+    std::uint64_t count() const { return total_; }
+    std::uint64_t min() const { return total_ ? min_ : 0; }
+    std::uint64_t max() const { return max_; }
+    double mean() const { return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0; }
+
+    // Value at quantile q in [0,1]; reports the upper bound of the matching bucket (clipped to max).
+    std::uint64_t percentile(double q) const {
+        if (total_ == 0) return 0;
+        if (q <= 0.0) return min();
+        if (q >= 1.0) return max_;
+        std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(total_));
+        if (rank < 1) rank = 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(bucket_upper(i), max_);
+        }
+        return max_;
+    }
+
+private:
+    static inline std::size_t bucket_of(std::uint64_t v) {
+        if (v < 2 * kSubCount) return static_cast<std::size_t>(v);
+        const unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(v));
+        const unsigned shift = msb - kSubBits;
+        const std::uint64_t sub = v >> shift; // in [kSubCount, 2*kSubCount)
+        return static_cast<std::size_t>((shift + 1) * kSubCount + (sub - kSubCount));
+    }
+
+    static std::uint64_t bucket_upper(std::size_t i) {
+        if (i < 2 * kSubCount) return i;
+        const std::uint64_t shift = i / kSubCount - 1;
+        const std::uint64_t sub = (i % kSubCount) + kSubCount;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::uint64_t counts_[kBuckets];
+    std::uint64_t total_;
+    std::uint64_t sum_;
+    std::uint64_t min_;
+    std::uint64_t max_;
+};
+
+} // namespace lt
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "CacheLine.h"
+
+namespace lt {
+
+// Spacing of lock instances inside a LockArena.
+enum class LockLayout {
+    Line,   // "line": every instance starts on its own cache line (no false sharing between locks)
+    Packed, // "packed": sizeof(L) rounded to alignof(L), as tight as the type allows
+};
+
+inline std::size_t lock_align_for(std::size_t align, LockLayout layout) {
+    return layout == LockLayout::Line && align < kCacheLine ? kCacheLine : align;
+}
+
+inline std::size_t lock_stride_for(std::size_t size, std::size_t align, LockLayout layout) {
+    const std::size_t a = lock_align_for(align, layout);
+    return (size + a - 1) / a * a;
+}
+
+// count instances of one concrete lock type in a single aligned allocation, addressed through
+// interface I by index. Lookup is base + k * stride (no pointer table), so a run over millions
+// of locks touches only the locks themselves.
+template <class I>
+class LockArena {
+public:
+    LockArena() = default;
+    LockArena(const LockArena&) = delete;
+    LockArena& operator=(const LockArena&) = delete;
+    LockArena(LockArena&& o) noexcept { swap(o); }
+    LockArena& operator=(LockArena&& o) noexcept {
+        LockArena tmp(std::move(o));
+        swap(tmp);
+        return *this;
+    }
+    ~LockArena() {
+        if (base_ == nullptr) return;
+        destroy_(base_, count_, stride_);
+        if (!external_) ::operator delete(base_, std::align_val_t(align_));
+    }
+
+    // construct(void* where) placement-constructs one L and returns it.
+    template <class L, class Construct>
+    static LockArena build(std::size_t count, LockLayout layout, Construct construct) {
+        if (count == 0) return LockArena{};
+        const std::size_t stride = lock_stride_for(sizeof(L), alignof(L), layout);
+        const std::size_t align = lock_align_for(alignof(L), layout);
+        char* base = static_cast<char*>(::operator new(stride * count, std::align_val_t(align)));
+        return place<L>(base, false, count, layout, construct);
+    }
+
+    // Same in caller-provided storage of lock_stride_for() * count bytes aligned to
+    // lock_align_for() (e.g. a mapping shared with other processes); owner keeps that
+    // storage alive until the instances have been destroyed.
+    template <class L, class Construct>
+    static LockArena build_in(void* storage, std::shared_ptr<void> owner, std::size_t count, LockLayout layout,
+                              Construct construct) {
+        assert(reinterpret_cast<std::uintptr_t>(storage) % lock_align_for(alignof(L), layout) == 0);
+        if (count == 0) return LockArena{};
+        LockArena a = place<L>(static_cast<char*>(storage), true, count, layout, construct);
+        a.owner_ = std::move(owner);
+        return a;
+    }
+
+    inline I* at(std::size_t k) const { return std::launder(reinterpret_cast<I*>(base_ + k * stride_ + offset_)); }
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    std::size_t stride() const { return stride_; }
+    std::size_t bytes() const { return stride_ * count_; }
+
+private:
+    template <class L, class Construct>
+    static LockArena place(char* base, bool external, std::size_t count, LockLayout layout, Construct& construct) {
+        static_assert(std::is_base_of_v<I, L>, "arena element must implement the interface");
+        LockArena a;
+        a.base_ = base;
+        a.external_ = external;
+        a.stride_ = lock_stride_for(sizeof(L), alignof(L), layout);
+        a.align_ = lock_align_for(alignof(L), layout);
+        a.destroy_ = [](char* b, std::size_t n, std::size_t stride) {
+            for (std::size_t k = 0; k < n; ++k) std::launder(reinterpret_cast<L*>(b + k * stride))->~L();
+        };
+        for (; a.count_ < count; ++a.count_) {
+            L* obj = construct(a.base_ + a.count_ * a.stride_);
+            if (a.count_ == 0) {
+                a.offset_ = static_cast<std::size_t>(reinterpret_cast<char*>(static_cast<I*>(obj)) - reinterpret_cast<char*>(obj));
+            }
+        }
+        return a;
+    }
+
+    void swap(LockArena& o) noexcept {
+        std::swap(base_, o.base_);
+        std::swap(count_, o.count_);
+        std::swap(stride_, o.stride_);
+        std::swap(offset_, o.offset_);
+        std::swap(align_, o.align_);
+        std::swap(destroy_, o.destroy_);
+        std::swap(external_, o.external_);
+        std::swap(owner_, o.owner_);
+    }
+
+    char* base_ {nullptr};
+    std::size_t count_ {0};
+    std::size_t stride_ {0};
+    std::size_t offset_ {0};  // I subobject offset inside L (same for every element)
+    std::size_t align_ {1};
+    void (*destroy_)(char*, std::size_t, std::size_t) {nullptr};
+    bool external_ {false};         // storage from build_in(): not ours to free
+    std::shared_ptr<void> owner_;   // build_in(): keeps that storage mapped
+};
+
+} // namespace lt
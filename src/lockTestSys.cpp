@@ -1,4 +1,8 @@
 #include "lockTestSys.h"
+#include "ThreadSlot.h"
+#include "workerPool.h"
+#include "shmRegion.h"
+#include "CacheLine.h"
 
 #include <pthread.h>
 #include <cassert>
@@ -6,50 +10,94 @@
 #include <vector>
 #include <new>
 #include <chrono>
+#include <algorithm>
 #include <atomic>
 #include <thread>
+#include <cmath>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
 #include <time.h>
 #if defined(__linux__)
 #include <unistd.h>
 #include <sched.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
 #endif
 // Adopt libslock-style timing: coordinated start, main-thread sleep window, global stop flag
 
 namespace lt {
 
 namespace {
-// Determine cache line size at compile time; fallback to 64 if not available
-#if defined(__cpp_lib_hardware_interference_size)
-constexpr std::size_t kCacheLineSize = std::hardware_destructive_interference_size;
-#else
-constexpr std::size_t kCacheLineSize = 64;
-#endif
-static_assert(kCacheLineSize >= sizeof(std::uint64_t), "Cache line size must be >= 8 bytes");
-
-// Padding to reduce false sharing when storing results
-struct alignas(kCacheLineSize) ThreadResult {
+// Aligned to whole cache lines to avoid false sharing when storing results
+struct alignas(kCacheLine) ThreadResult {
     std::uint64_t count;
-    char pad[kCacheLineSize - sizeof(std::uint64_t)];
-};
-static_assert(sizeof(ThreadResult) == kCacheLineSize, "ThreadResult should occupy exactly one cache line");
-
-struct SharedTiming {
-    std::atomic<bool> start{false};
-    std::atomic<bool> stop{false};
-    std::atomic<int> ready{0};
-    double endTime{0.0}; // unused with libslock-style timing
-    double durationSeconds{0.0}; // broadcasted window length (seconds)
-    int total{0};
+    std::uint64_t readCount;      // reader-writer loop: shared acquisitions among count
+    std::uint64_t voluntaryCsw;   // context switches inside the measured loop (Linux only)
+    std::uint64_t involuntaryCsw;
+    PerfValues perf;              // counters of the measured loop (empty unless enabled)
+    std::uint64_t startNs, endNs; // this worker's loop span (steady_clock and TSC)
+    std::uint64_t startTicks, endTicks;
+    std::atomic<std::uint64_t> progress{0}; // running count for the sampler; only this worker writes it
 };
+static_assert(sizeof(ThreadResult) % kCacheLine == 0, "ThreadResult should occupy whole cache lines");
+
+using detail::SharedTiming;
 
 struct ThreadCtxLock {
-    iLock* lock;
+    detail::LoopFn loop;
+    void* env;
     iRunTask* task;
-    SharedTiming* timing;
     ThreadResult* resultSlot;
+    detail::WorkerCtx worker;
     int cpuId; // target CPU id for pinning
+    const PerfConfig* perf;
 };
 
+// Per-thread (voluntary, involuntary) context switch counters; zero where unsupported.
+void thread_csw(std::uint64_t& vol, std::uint64_t& invol) {
+    vol = invol = 0;
+#if defined(__linux__) && defined(RUSAGE_THREAD)
+    rusage ru;
+    if (getrusage(RUSAGE_THREAD, &ru) == 0) {
+        vol = static_cast<std::uint64_t>(ru.ru_nvcsw);
+        invol = static_cast<std::uint64_t>(ru.ru_nivcsw);
+    }
+#endif
+}
+
+// Body of one worker for one run; the calling thread is already pinned.
+void run_worker(ThreadCtxLock* ctx) {
+    set_this_thread_slot(ctx->worker.slot);
+    ctx->task->prepare_thread(); // pinned already: per-thread memory lands on this CPU's node
+    // counters are opened disabled before ready, so setup is never counted
+    PerfCounterGroup counters;
+    if (ctx->perf->enabled) counters.open(*ctx->perf);
+    // signal ready and wait for synchronized start
+    ctx->worker.timing->ready.fetch_add(1, std::memory_order_acq_rel);
+    while (!ctx->worker.timing->start.load(std::memory_order_acquire)) {
+        // spin until main thread starts the test window
+    }
+    std::uint64_t vol0, invol0, vol1, invol1;
+    thread_csw(vol0, invol0);
+    counters.enable();
+    const std::uint64_t startNs = detail::now_ns(), startTicks = tsc_now();
+    const std::uint64_t localCount = ctx->loop(ctx->env, ctx->worker);
+    const std::uint64_t endTicks = tsc_now(), endNs = detail::now_ns();
+    counters.disable(); // loop returns as soon as it sees stop
+    thread_csw(vol1, invol1);
+    ctx->resultSlot->startNs = startNs;
+    ctx->resultSlot->endNs = endNs;
+    ctx->resultSlot->startTicks = startTicks;
+    ctx->resultSlot->endTicks = endTicks;
+    ctx->resultSlot->count = localCount; // single write on exit
+    ctx->resultSlot->readCount = ctx->worker.readOps;
+    ctx->resultSlot->voluntaryCsw = vol1 - vol0;
+    ctx->resultSlot->involuntaryCsw = invol1 - invol0;
+    ctx->resultSlot->perf = counters.read();
+}
+
 void* thread_func_lock(void* arg) {
     auto* ctx = static_cast<ThreadCtxLock*>(arg);
     // Bind this thread to a specific CPU if available (Linux)
@@ -61,45 +109,142 @@ void* thread_func_lock(void* arg) {
         (void)pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
     }
 #endif
-    std::uint64_t localCount = 0;
-    // signal ready and wait for synchronized start
-    ctx->timing->ready.fetch_add(1, std::memory_order_acq_rel);
-    while (!ctx->timing->start.load(std::memory_order_acquire)) {
-        // spin until main thread starts the test window
+    run_worker(ctx);
+    return nullptr;
+}
+
+// WorkerPool job: worker i runs context i (the pool has pinned it to cpuIds[i]).
+void pool_job(int worker, void* arg) {
+    run_worker(&static_cast<ThreadCtxLock*>(arg)[worker]);
+}
+
+// n value-initialized T, from the shared mapping in cross-process mode (given back with the
+// region mark, never destroyed) or else from local.
+template <class T>
+T* harness_array(ShmRegion* shm, std::vector<T>& local, int n) {
+    static_assert(std::is_trivially_destructible_v<T>, "shared harness state is released, not destroyed");
+    if (n <= 0) return nullptr;
+    if (shm == nullptr) {
+        local = std::vector<T>(static_cast<std::size_t>(n));
+        return local.data();
     }
-    // Per-thread local end time to avoid cross-core TSC skew issues
-    const int checkEvery = 64; // amortize time checks, keep overshoot bounded
-    for (;;) {
-        if ((localCount & (checkEvery - 1)) == 0) {
-            if (ctx->timing->stop.load(std::memory_order_acquire)) {
-                break;
-            }
+    T* p = static_cast<T*>(shm->allocate(sizeof(T) * static_cast<std::size_t>(n), alignof(T)));
+    for (int i = 0; i < n; ++i) new (p + i) T();
+    return p;
+}
+
+#if defined(__linux__)
+// Waits for every worker process; false if one did not exit normally.
+bool reap_workers(const std::vector<pid_t>& pids) {
+    bool ok = true;
+    for (pid_t pid : pids) {
+        int status = 0;
+        pid_t r;
+        while ((r = waitpid(pid, &status, 0)) < 0 && errno == EINTR) {
         }
-        // majority of work that can run without lock
-        ctx->task->run_parallel();
+        if (r < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = false;
+    }
+    return ok;
+}
 
-        // critical section protected by the lock
-        ctx->lock->lock();
-        ctx->task->run_locked();
-        ctx->lock->unlock();
-        ++localCount;
+// True once any worker process has terminated (left unreaped).
+bool worker_exited(const std::vector<pid_t>& pids) {
+    for (pid_t pid : pids) {
+        siginfo_t info {};
+        if (waitid(P_PID, static_cast<id_t>(pid), &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid != 0) {
+            return true;
+        }
     }
-    ctx->resultSlot->count = localCount; // single write on exit
-    return nullptr;
+    return false;
+}
+
+// Releases workers waiting at the start barrier (they see stop at once) and reaps them all.
+void abort_workers(SharedTiming& timing, const std::vector<pid_t>& pids) {
+    timing.stop.store(true, std::memory_order_release);
+    timing.start.store(true, std::memory_order_release);
+    (void)reap_workers(pids);
 }
 
+// Cross-process mode: one forked worker per context. The child pins itself like a fresh
+// thread would, runs its loop and leaves with _exit(), so neither atexit handlers nor the
+// copy of the parent's stdio buffers run in it.
+std::vector<pid_t> fork_workers(std::vector<ThreadCtxLock>& ctxs, SharedTiming& timing) {
+    std::vector<pid_t> pids;
+    pids.reserve(ctxs.size());
+    for (auto& ctx : ctxs) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            thread_func_lock(&ctx);
+            _exit(0);
+        }
+        if (pid < 0) {
+            const int err = errno;
+            abort_workers(timing, pids);
+            throw std::system_error(err, std::generic_category(), "fork");
+        }
+        pids.push_back(pid);
+    }
+    return pids;
+}
+#endif
+
 } // namespace
 
-std::uint64_t LockTestSys::run_test() {
-    assert(lock_ && task_);
-    task_->reset();
+FairnessStats compute_fairness(const std::vector<std::uint64_t>& perThreadOps) {
+    FairnessStats f;
+    if (perThreadOps.empty()) return f;
+    const double n = static_cast<double>(perThreadOps.size());
+    long double sum = 0, sumSq = 0;
+    f.minOps = perThreadOps[0];
+    f.maxOps = perThreadOps[0];
+    for (std::uint64_t c : perThreadOps) {
+        sum += c;
+        sumSq += static_cast<long double>(c) * c;
+        if (c < f.minOps) f.minOps = c;
+        if (c > f.maxOps) f.maxOps = c;
+    }
+    if (sum == 0) return f;
+    const double mean = static_cast<double>(sum / n);
+    const double var = std::max(0.0, static_cast<double>(sumSq / n) - mean * mean);
+    f.cv = std::sqrt(var) / mean;
+    f.jain = static_cast<double>((sum * sum) / (n * sumSq));
+    for (std::uint64_t c : perThreadOps) {
+        if (static_cast<double>(c) < kStarvedFraction * mean) ++f.starved;
+    }
+    return f;
+}
+
+namespace detail {
 
-    std::vector<pthread_t> threads(numThreads_);
-    std::vector<ThreadResult> results(numThreads_);
-    SharedTiming timing;
-    timing.total = numThreads_;
+std::size_t process_harness_bytes(int numThreads) {
+    const std::size_t n = static_cast<std::size_t>(numThreads > 0 ? numThreads : 0);
+    // timing + results + latency / response / handover histograms, each padded to its alignment
+    return 2 * sizeof(SharedTiming) + n * sizeof(ThreadResult) + 3 * n * sizeof(LatencyHistogram) + 5 * kCacheLine;
+}
 
-    // Determine CPU count and build a simple round-robin mapping
+RunResult run_harness(int numThreads, double durationSeconds, const RunOptions& options, LoopFn loop, void* env,
+                      iRunTask* task) {
+    ShmRegion* shm = options.processes.get();
+    const std::size_t shmMark = shm ? shm->mark() : 0;
+    std::vector<pthread_t> threads(numThreads);
+    std::vector<ThreadResult> localResults;
+    ThreadResult* results = harness_array(shm, localResults, numThreads);
+    // Histograms are allocated up front so workers never allocate inside the window
+    const bool openLoop = options.arrivalRate > 0.0;
+    const int numLatencies = options.recordLatency ? numThreads : 0;
+    const int numResponses = openLoop ? numThreads : 0;
+    const int numHandovers = options.recordHandover ? numThreads : 0;
+    std::vector<LatencyHistogram> localLatencies, localResponses, localHandovers;
+    LatencyHistogram* latencies = harness_array(shm, localLatencies, numLatencies);
+    LatencyHistogram* responses = harness_array(shm, localResponses, numResponses);
+    LatencyHistogram* handovers = harness_array(shm, localHandovers, numHandovers);
+    // each worker is an independent source of rate/n; a sum of Poisson sources is Poisson
+    const double meanGapNs = openLoop ? 1e9 * numThreads / options.arrivalRate : 0.0;
+    std::vector<SharedTiming> localTiming;
+    SharedTiming& timing = *harness_array(shm, localTiming, 1);
+    timing.total = numThreads;
+    // Use the caller's placement if it covers every worker, else a simple round-robin mapping
+    const bool haveMap = static_cast<int>(options.cpuMap.size()) >= numThreads;
     int ncpu = 1;
 #if defined(__linux__)
     long n = sysconf(_SC_NPROCESSORS_ONLN);
@@ -109,24 +254,85 @@ std::uint64_t LockTestSys::run_test() {
     if (hc > 0) ncpu = static_cast<int>(hc);
 #endif
 
-    std::vector<ThreadCtxLock*> ctx_ptrs(numThreads_, nullptr);
-    for (int i = 0; i < numThreads_; ++i) {
-        int cpuId = (ncpu > 0) ? (i % ncpu) : -1;
-        ctx_ptrs[i] = new ThreadCtxLock{ lock_.get(), task_.get(), &timing, &results[i], cpuId };
-        pthread_create(&threads[i], nullptr, &thread_func_lock, ctx_ptrs[i]);
+    std::vector<ThreadCtxLock> ctxs;
+    std::vector<int> cpuIds(numThreads);
+    ctxs.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        cpuIds[i] = haveMap ? options.cpuMap[i] : ((ncpu > 0) ? (i % ncpu) : -1);
+        LatencyHistogram* hist = numLatencies ? &latencies[i] : nullptr;
+        LatencyHistogram* resp = numResponses ? &responses[i] : nullptr;
+        LatencyHistogram* hand = numHandovers ? &handovers[i] : nullptr;
+        ctxs.push_back(ThreadCtxLock{ loop, env, task, &results[i],
+                                      WorkerCtx{ &timing, hist, i, options.readRatio, 0, &results[i].progress,
+                                                 resp, meanGapNs, options.arrivals, hand, options.opsPerThread },
+                                      cpuIds[i], &options.perf });
+    }
+    std::vector<pid_t> pids;
+    if (shm) {
+#if defined(__linux__)
+        pids = fork_workers(ctxs, timing);
+#endif
+    } else if (options.pool) {
+        options.pool->dispatch(cpuIds, &pool_job, ctxs.data());
+    } else {
+        for (int i = 0; i < numThreads; ++i) {
+            pthread_create(&threads[i], nullptr, &thread_func_lock, &ctxs[i]);
+        }
     }
     // wait for all threads to be ready
-    while (timing.ready.load(std::memory_order_acquire) < numThreads_) {
-        // spin
+    while (timing.ready.load(std::memory_order_acquire) < numThreads) {
+        // spin; a worker process that died during setup would never arrive
+#if defined(__linux__)
+        if (!pids.empty() && worker_exited(pids)) {
+            abort_workers(timing, pids);
+            throw std::runtime_error("worker process exited before the start barrier");
+        }
+#endif
     }
     // broadcast duration and start flag (threads compute local end time)
-    timing.durationSeconds = durationSeconds_;
+    timing.durationSeconds = durationSeconds;
     timing.start.store(true, std::memory_order_release);
-    // Main thread controls test window like libslock (nanosleep + stop flag)
-    {
+    // Sampler: reads the workers' own progress lines, so the hot loop gains no shared write
+    RunResult out;
+    std::thread sampler;
+    if (options.sampleIntervalMs > 0.0) {
+        out.samples.reserve(static_cast<std::size_t>(durationSeconds * 1000.0 / options.sampleIntervalMs) + 1);
+        sampler = std::thread([&] {
+            const auto t0 = std::chrono::steady_clock::now();
+            const auto period = std::chrono::duration<double, std::milli>(options.sampleIntervalMs);
+            for (int k = 1;; ++k) {
+                std::this_thread::sleep_until(t0 + std::chrono::duration_cast<std::chrono::steady_clock::duration>(period * k));
+                if (timing.stop.load(std::memory_order_acquire)) break;
+                ProgressSample ps;
+                ps.tMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+                ps.perThreadOps.resize(numThreads);
+                for (int i = 0; i < numThreads; ++i) {
+                    ps.perThreadOps[i] = results[i].progress.load(std::memory_order_relaxed);
+                }
+                out.samples.push_back(std::move(ps));
+            }
+        });
+    }
+    // Main thread controls test window like libslock (nanosleep + stop flag); a counted run
+    // has no window, the workers finish on their own
+    const bool counted = options.opsPerThread > 0;
+    bool workersOk = true;
+    if (counted) {
+        if (shm) {
+#if defined(__linux__)
+            workersOk = reap_workers(pids);
+#endif
+        } else if (options.pool) {
+            options.pool->wait();
+        } else {
+            for (int i = 0; i < numThreads; ++i) {
+                pthread_join(threads[i], nullptr);
+            }
+        }
+    } else {
         timespec ts;
-        ts.tv_sec = static_cast<time_t>(durationSeconds_);
-        ts.tv_nsec = static_cast<long>((durationSeconds_ - static_cast<double>(ts.tv_sec)) * 1e9);
+        ts.tv_sec = static_cast<time_t>(durationSeconds);
+        ts.tv_nsec = static_cast<long>((durationSeconds - static_cast<double>(ts.tv_sec)) * 1e9);
         // Ensure tv_nsec in range
         if (ts.tv_nsec >= 1000000000L) {
             ts.tv_sec += ts.tv_nsec / 1000000000L;
@@ -136,19 +342,64 @@ std::uint64_t LockTestSys::run_test() {
         nanosleep(&ts, nullptr);
     }
     timing.stop.store(true, std::memory_order_release);
+    if (sampler.joinable()) sampler.join();
 
-    std::uint64_t total = 0;
-    for (int i = 0; i < numThreads_; ++i) {
-        pthread_join(threads[i], nullptr);
+    if (counted) {
+        // already joined above
+    } else if (shm) {
+#if defined(__linux__)
+        workersOk = reap_workers(pids);
+#endif
+    } else if (options.pool) {
+        options.pool->wait();
+    } else {
+        for (int i = 0; i < numThreads; ++i) {
+            pthread_join(threads[i], nullptr);
+        }
+    }
+    if (!workersOk) throw std::runtime_error("worker process exited abnormally");
+    out.perThreadOps.resize(numThreads);
+    std::uint64_t firstNs = UINT64_MAX, lastNs = 0, firstTicks = UINT64_MAX, lastTicks = 0;
+    for (int i = 0; i < numThreads; ++i) {
+        out.perThreadOps[i] = results[i].count;
+        out.totalOps += results[i].count;
+        out.readOps += results[i].readCount;
+        out.voluntaryCsw += results[i].voluntaryCsw;
+        out.involuntaryCsw += results[i].involuntaryCsw;
+        out.perf.accumulate(results[i].perf, i == 0);
+        firstNs = std::min(firstNs, results[i].startNs);
+        lastNs = std::max(lastNs, results[i].endNs);
+        firstTicks = std::min(firstTicks, results[i].startTicks);
+        lastTicks = std::max(lastTicks, results[i].endTicks);
+    }
+    if (numThreads > 0) {
+        out.elapsedNs = static_cast<double>(lastNs - firstNs);
+        out.elapsedTicks = lastTicks > firstTicks ? lastTicks - firstTicks : 0;
     }
-    for (int i = 0; i < numThreads_; ++i) {
-        delete ctx_ptrs[i];
+    out.fairness = compute_fairness(out.perThreadOps);
+    for (int i = 0; i < numLatencies; ++i) {
+        out.lockLatency.merge(latencies[i]);
     }
-    for (int i = 0; i < numThreads_; ++i) {
-        total += results[i].count;
+    for (int i = 0; i < numResponses; ++i) {
+        out.responseLatency.merge(responses[i]);
     }
-    return total;
+    if (static_cast<int>(options.threadGroups.size()) >= numThreads && numThreads > 0) {
+        const int groups = *std::max_element(options.threadGroups.begin(), options.threadGroups.begin() + numThreads) + 1;
+        out.groupLatency.resize(numLatencies ? groups : 0);
+        out.groupResponse.resize(numResponses ? groups : 0);
+        for (int i = 0; i < numThreads; ++i) {
+            const int g = options.threadGroups[i];
+            if (numLatencies) out.groupLatency[g].merge(latencies[i]);
+            if (numResponses) out.groupResponse[g].merge(responses[i]);
+        }
+    }
+    for (int i = 0; i < numHandovers; ++i) {
+        out.handoverLatency.merge(handovers[i]);
+    }
+    if (shm) shm->release(shmMark);
+    return out;
 }
- 
+
+} // namespace detail
 
 } // namespace lt
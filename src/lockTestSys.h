@@ -1,37 +1,590 @@
 #pragma once
 
+#include <atomic>
+#include <cassert>
 #include <cstdint>
 #include <memory>
+#include <type_traits>
 #include <vector>
 #include <chrono>
+#include <cmath>
 
+#include "Backoff.h"
+#include "CacheLine.h"
 #include "iLock.h"
+#include "iRWLock.h"
+#include "iDelegationLock.h"
+#include "iAtomicBaseline.h"
 #include "iRunTask.h"
+#include "XorShift.h"
+#include "latencyHistogram.h"
+#include "lockArena.h"
+#include "keyDistribution.h"
+#include "perfCounters.h"
+#include "tscTimer.h"
+#include "tasks/SharedDataTask.h"
 
 namespace lt {
 
-class LockTestSys {
+class WorkerPool;
+class ShmRegion;
+
+// Arrival process of the open-loop mode (RunOptions::arrivalRate > 0).
+enum class ArrivalProcess {
+    Poisson, // exponential inter-arrival gaps
+    Fixed,   // constant gap, random phase per worker
+};
+
+// Optional measurement features; defaults reproduce the plain throughput run.
+struct RunOptions {
+    bool recordLatency {false}; // time every lock() call into a per-thread histogram
+    std::vector<int> cpuMap;    // CPU for worker i (see topology.h); empty = round-robin over CPU ids
+    double readRatio {-1.0};    // >= 0 selects the reader-writer loop (iRWLock only): P(read) per iteration
+    PerfConfig perf;            // per-worker perf_event_open counters, enabled only inside the window
+    WorkerPool* pool {nullptr}; // persistent workers reused across runs; nullptr = create/join per run
+    double sampleIntervalMs {0.0}; // > 0: sampler thread snapshots per-thread progress at this period
+    KeySpec keys;               // striped runs (several lock instances): how each iteration picks a stripe
+    double arrivalRate {0.0};   // > 0 selects the open-loop loop: aggregate offered ops/s over all workers
+    ArrivalProcess arrivals {ArrivalProcess::Poisson};
+    bool recordHandover {false}; // handover loop: time from unlock() to the next owner's lock() return
+    std::uint64_t opsPerThread {0}; // > 0: every worker runs exactly this many rounds, no time window
+    std::vector<int> threadGroups; // group id of worker i: latencies are also merged per group; empty = none
+    // set: workers are forked processes (pool unused) and everything they write -- timing
+    // flags, results, histograms -- is carved from this mapping, next to the locks
+    std::shared_ptr<ShmRegion> processes;
+};
+
+// Spread of per-thread operation counts within one run.
+struct FairnessStats {
+    std::uint64_t minOps {0};
+    std::uint64_t maxOps {0};
+    double cv {0.0};    // coefficient of variation: stddev / mean of per-thread ops
+    double jain {1.0};  // Jain index (sum x)^2 / (n * sum x^2): 1 = fair, 1/n = one thread did all work
+    int starved {0};    // threads that completed less than kStarvedFraction of the mean
+};
+
+// A thread below this fraction of the mean per-thread count is reported as starved.
+constexpr double kStarvedFraction = 0.1;
+
+FairnessStats compute_fairness(const std::vector<std::uint64_t>& perThreadOps);
+
+// Snapshot taken by the sampler thread: cumulative per-thread ops at tMs after start.
+struct ProgressSample {
+    double tMs {0.0};
+    std::vector<std::uint64_t> perThreadOps;
+};
+
+// Outcome of one run_test() call.
+struct RunResult {
+    std::uint64_t totalOps {0};             // operations completed across all threads
+    std::uint64_t readOps {0};              // reader-writer loop: shared acquisitions (rest are writes)
+    std::vector<std::uint64_t> perThreadOps; // indexed by worker id
+    FairnessStats fairness;                 // derived from perThreadOps
+    std::uint64_t voluntaryCsw {0};         // context switches of all workers inside the measured loop
+    std::uint64_t involuntaryCsw {0};
+    LatencyHistogram lockLatency;           // merged lock() wait time in ns (empty unless recordLatency)
+    LatencyHistogram responseLatency;       // open loop: scheduled arrival -> critical section done, in ns
+    LatencyHistogram handoverLatency;       // handover loop: release -> next owner acquired, in ns (TSC)
+    std::vector<LatencyHistogram> groupLatency;  // lockLatency split by options.threadGroups
+    std::vector<LatencyHistogram> groupResponse; // responseLatency split by options.threadGroups
+    PerfValues perf;                        // counters summed over workers (validMask 0 unless perf.enabled)
+    std::vector<ProgressSample> samples;    // time series (empty unless sampleIntervalMs > 0)
+    double elapsedNs {0.0};                 // first worker start -> last worker finish (steady_clock)
+    std::uint64_t elapsedTicks {0};         // the same span in TSC ticks
+    std::int64_t lockedCount {-1};          // shared_data: critical sections the task counted (-1 for other tasks)
+    std::int64_t baselineCount {-1};        // atomic baselines: increase of value() over the run (-1 for locks)
+};
+
+namespace detail {
+
+struct SharedTiming {
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::atomic<int> ready{0};
+    double endTime{0.0}; // unused with libslock-style timing
+    double durationSeconds{0.0}; // broadcasted window length (seconds)
+    int total{0};
+};
+
+// What the harness hands to the measured loop of one worker.
+struct WorkerCtx {
+    SharedTiming* timing;
+    LatencyHistogram* latency; // per-thread histogram, nullptr unless latency recording is on
+    int slot;                  // dense worker id (also published via set_this_thread_slot())
+    double readRatio;          // reader-writer loop: probability of a read iteration
+    std::uint64_t readOps;     // out: reader-writer loop read iterations
+    std::atomic<std::uint64_t>* progress; // worker-owned cache line; relaxed count published at each stop check
+    LatencyHistogram* response; // open loop: per-thread response time histogram, else nullptr
+    double meanGapNs;           // open loop: this worker's mean inter-arrival gap
+    ArrivalProcess arrivals;
+    LatencyHistogram* handover; // handover loop: per-thread histogram, else nullptr
+    std::uint64_t opsLimit;     // counted loop: rounds to run
+};
+
+// Measured loop of one worker: opaque environment plus the worker's context; returns its op count.
+using LoopFn = std::uint64_t (*)(void* env, WorkerCtx& w);
+
+// Type-independent part of a run: pinning, start/stop timing, join and result merging.
+// task->prepare_thread() runs on every worker before the start barrier.
+RunResult run_harness(int numThreads, double durationSeconds, const RunOptions& options, LoopFn loop, void* env,
+                      iRunTask* task);
+
+// Bytes of RunOptions::processes one run_harness() call over numThreads workers needs (it
+// releases them again before returning).
+std::size_t process_harness_bytes(int numThreads);
+
+inline std::uint64_t now_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+template <class L>
+constexpr bool kIsLockInterface =
+    std::is_same_v<L, iLock> || std::is_same_v<L, iRWLock> || std::is_same_v<L, iDelegationLock> ||
+    std::is_same_v<L, iAtomicBaseline>;
+
+// Member calls used by the loop. For the interface types (iLock / iRWLock / iDelegationLock /
+// iAtomicBaseline / iRunTask) they dispatch virtually; for concrete types the qualified call
+// binds statically and can be inlined.
+template <class Lock, class Task>
+struct Calls {
+    static inline void lock(Lock* l) {
+        if constexpr (kIsLockInterface<Lock>) l->lock(); else l->Lock::lock();
+    }
+    static inline void unlock(Lock* l) {
+        if constexpr (kIsLockInterface<Lock>) l->unlock(); else l->Lock::unlock();
+    }
+    static inline void lock_shared(Lock* l) {
+        if constexpr (kIsLockInterface<Lock>) l->lock_shared(); else l->Lock::lock_shared();
+    }
+    static inline void unlock_shared(Lock* l) {
+        if constexpr (kIsLockInterface<Lock>) l->unlock_shared(); else l->Lock::unlock_shared();
+    }
+    static inline void run_parallel(Task* t) {
+        if constexpr (std::is_same_v<Task, iRunTask>) t->run_parallel(); else t->Task::run_parallel();
+    }
+    static inline void run_locked(Task* t) {
+        if constexpr (std::is_same_v<Task, iRunTask>) t->run_locked(); else t->Task::run_locked();
+    }
+    static inline void run_locked_read(Task* t) {
+        if constexpr (std::is_same_v<Task, iRunTask>) t->run_locked_read(); else t->Task::run_locked_read();
+    }
+    static inline void run_locked_stripe(Task* t, int stripe) {
+        if constexpr (std::is_same_v<Task, iRunTask>) t->run_locked_stripe(stripe); else t->Task::run_locked_stripe(stripe);
+    }
+    // Delegation engines: hand run_locked to the engine instead of lock/run_locked/unlock.
+    static inline void execute(Lock* l, Task* t) {
+        iDelegationLock::Section section = [](void* arg) { run_locked(static_cast<Task*>(arg)); };
+        if constexpr (kIsLockInterface<Lock>) l->execute(section, t); else l->Lock::execute(section, t);
+    }
+    static inline void execute_stripe(Lock* l, Task* t, int stripe) {
+        struct Arg { Task* task; int stripe; } arg{t, stripe}; // lives until execute() returns
+        iDelegationLock::Section section = [](void* a) {
+            auto* p = static_cast<Arg*>(a);
+            run_locked_stripe(p->task, p->stripe);
+        };
+        if constexpr (kIsLockInterface<Lock>) l->execute(section, &arg); else l->Lock::execute(section, &arg);
+    }
+    // Lock-free baselines: the engine's own atomic update replaces the whole critical section.
+    static inline void update(Lock* l) {
+        if constexpr (kIsLockInterface<Lock>) l->update(); else l->Lock::update();
+    }
+};
+
+// Stamp kept next to the protected state by the handover loop; written only under the lock.
+struct alignas(kCacheLine) HandoverStamp {
+    std::uint64_t releaseTicks {0}; // tsc_now() just before the last unlock()
+    int owner {-1};                 // slot of the thread that released it
+};
+
+template <class Lock, class Task>
+struct LoopEnv {
+    Lock* lock;
+    Task* task;
+    const LockArena<Lock>* stripes {nullptr}; // striped loop: keys->stripes() lock instances
+    const KeyTable* keys {nullptr};
+    HandoverStamp* handover {nullptr}; // handover loop: the stamp guarded by lock
+};
+
+// One critical section: run_locked(), or run_locked_stripe(stripe) when stripe >= 0 (the
+// plain loop passes a constant -1, so that branch folds away).
+template <class Lock, class Task, bool RecordLatency>
+inline void critical_section(Lock* lock, Task* task, int stripe, WorkerCtx& w) {
+    using C = Calls<Lock, Task>;
+    if constexpr (std::is_base_of_v<iAtomicBaseline, Lock>) {
+        C::update(lock);
+    } else if constexpr (std::is_base_of_v<iDelegationLock, Lock>) {
+        // critical section runs wherever the engine puts it; latency is the whole round trip
+        std::uint64_t t0 = 0;
+        if constexpr (RecordLatency) t0 = now_ns();
+        if (stripe < 0) C::execute(lock, task); else C::execute_stripe(lock, task, stripe);
+        if constexpr (RecordLatency) w.latency->record(now_ns() - t0);
+    } else {
+        // critical section protected by the lock
+        if constexpr (RecordLatency) {
+            const std::uint64_t t0 = now_ns();
+            C::lock(lock);
+            w.latency->record(now_ns() - t0);
+        } else {
+            C::lock(lock);
+        }
+        if (stripe < 0) C::run_locked(task); else C::run_locked_stripe(task, stripe);
+        C::unlock(lock);
+    }
+}
+
+// Measured loop; RecordLatency is a template flag so the plain path carries no timing code.
+template <class Lock, class Task, bool RecordLatency>
+std::uint64_t worker_loop(Lock* lock, Task* task, WorkerCtx& w) {
+    using C = Calls<Lock, Task>;
+    std::uint64_t localCount = 0;
+    const int checkEvery = 64; // amortize time checks, keep overshoot bounded
+    for (;;) {
+        if ((localCount & (checkEvery - 1)) == 0) {
+            w.progress->store(localCount, std::memory_order_relaxed);
+            if (w.timing->stop.load(std::memory_order_acquire)) {
+                break;
+            }
+        }
+        // majority of work that can run without lock
+        C::run_parallel(task);
+
+        critical_section<Lock, Task, RecordLatency>(lock, task, -1, w);
+        ++localCount;
+    }
+    return localCount;
+}
+
+template <class Lock, class Task>
+std::uint64_t worker_entry(void* env, WorkerCtx& w) {
+    auto* e = static_cast<LoopEnv<Lock, Task>*>(env);
+    return w.latency ? worker_loop<Lock, Task, true>(e->lock, e->task, w)
+                     : worker_loop<Lock, Task, false>(e->lock, e->task, w);
+}
+
+// Counted loop: exactly w.opsLimit rounds and no stop flag, so there is no overshoot and
+// no dependence on when the main thread wakes up; the harness times first start to last
+// finish. Progress is still published every 64 rounds for the sampler.
+template <class Lock, class Task, bool RecordLatency>
+std::uint64_t counted_worker_loop(Lock* lock, Task* task, WorkerCtx& w) {
+    using C = Calls<Lock, Task>;
+    const std::uint64_t n = w.opsLimit;
+    const int checkEvery = 64;
+    for (std::uint64_t i = 0; i < n; ++i) {
+        if ((i & (checkEvery - 1)) == 0) w.progress->store(i, std::memory_order_relaxed);
+        C::run_parallel(task);
+
+        critical_section<Lock, Task, RecordLatency>(lock, task, -1, w);
+    }
+    return n;
+}
+
+template <class Lock, class Task>
+std::uint64_t counted_worker_entry(void* env, WorkerCtx& w) {
+    auto* e = static_cast<LoopEnv<Lock, Task>*>(env);
+    return w.latency ? counted_worker_loop<Lock, Task, true>(e->lock, e->task, w)
+                     : counted_worker_loop<Lock, Task, false>(e->lock, e->task, w);
+}
+
+// Striped loop: each iteration picks one of K lock instances from the run's key table using
+// a per-thread PRNG (no shared state besides the read-only table) and runs that stripe's
+// critical section.
+template <class Lock, class Task, bool RecordLatency>
+std::uint64_t striped_worker_loop(const LockArena<Lock>& stripes, const KeyTable& keys, Task* task, WorkerCtx& w) {
+    using C = Calls<Lock, Task>;
+    XorShift64 rng(static_cast<std::uint64_t>(w.slot));
+    std::uint64_t localCount = 0;
+    const int checkEvery = 64;
+    for (;;) {
+        if ((localCount & (checkEvery - 1)) == 0) {
+            w.progress->store(localCount, std::memory_order_relaxed);
+            if (w.timing->stop.load(std::memory_order_acquire)) {
+                break;
+            }
+        }
+        C::run_parallel(task);
+
+        const int k = keys.pick(rng.next());
+        critical_section<Lock, Task, RecordLatency>(stripes.at(static_cast<std::size_t>(k)), task, k, w);
+        ++localCount;
+    }
+    return localCount;
+}
+
+template <class Lock, class Task>
+std::uint64_t striped_worker_entry(void* env, WorkerCtx& w) {
+    auto* e = static_cast<LoopEnv<Lock, Task>*>(env);
+    return w.latency ? striped_worker_loop<Lock, Task, true>(*e->stripes, *e->keys, e->task, w)
+                     : striped_worker_loop<Lock, Task, false>(*e->stripes, *e->keys, e->task, w);
+}
+
+// Reader-writer loop: each iteration draws from a per-thread PRNG and takes the lock
+// shared (run_locked_read) with probability readRatio, exclusive (run_locked) otherwise.
+template <class Lock, class Task, bool RecordLatency>
+std::uint64_t rw_worker_loop(Lock* lock, Task* task, WorkerCtx& w) {
+    using C = Calls<Lock, Task>;
+    XorShift64 rng(static_cast<std::uint64_t>(w.slot));
+    // compare the top 32 random bits against a fixed threshold: no FP math in the loop
+    const std::uint64_t threshold = static_cast<std::uint64_t>(w.readRatio * 4294967296.0);
+    std::uint64_t localCount = 0, reads = 0;
+    const int checkEvery = 64;
+    for (;;) {
+        if ((localCount & (checkEvery - 1)) == 0) {
+            w.progress->store(localCount, std::memory_order_relaxed);
+            if (w.timing->stop.load(std::memory_order_acquire)) {
+                break;
+            }
+        }
+        C::run_parallel(task);
+
+        const bool isRead = (rng.next() >> 32) < threshold;
+        std::uint64_t t0 = 0;
+        if constexpr (RecordLatency) t0 = now_ns();
+        if (isRead) C::lock_shared(lock); else C::lock(lock);
+        if constexpr (RecordLatency) w.latency->record(now_ns() - t0);
+        if (isRead) {
+            C::run_locked_read(task);
+            C::unlock_shared(lock);
+            ++reads;
+        } else {
+            C::run_locked(task);
+            C::unlock(lock);
+        }
+        ++localCount;
+    }
+    w.readOps = reads;
+    return localCount;
+}
+
+template <class Lock, class Task>
+std::uint64_t rw_worker_entry(void* env, WorkerCtx& w) {
+    auto* e = static_cast<LoopEnv<Lock, Task>*>(env);
+    return w.latency ? rw_worker_loop<Lock, Task, true>(e->lock, e->task, w)
+                     : rw_worker_loop<Lock, Task, false>(e->lock, e->task, w);
+}
+
+// Open loop: the worker follows its own arrival schedule (aggregate rate / threads) instead
+// of issuing the next operation as soon as the last one returns. Latency is measured from
+// the scheduled arrival, not from when the worker got around to it, so a stall that delays
+// later arrivals is charged to all of them (no coordinated omission). Between arrivals the
+// worker spins, which keeps wake-up jitter out of the numbers; once it falls behind it runs
+// back to back and the response time grows with the backlog.
+template <class Lock, class Task, bool RecordLatency>
+std::uint64_t open_loop_worker_loop(const LoopEnv<Lock, Task>& env, WorkerCtx& w) {
+    using C = Calls<Lock, Task>;
+    XorShift64 rng(static_cast<std::uint64_t>(w.slot));
+    auto gap = [&] {
+        // 1 - uniform() is in (0, 1], so the log is finite
+        return w.arrivals == ArrivalProcess::Poisson ? -std::log(1.0 - rng.uniform()) * w.meanGapNs : w.meanGapNs;
+    };
+    // random phase so that fixed-rate workers do not arrive in lockstep
+    double arrival = static_cast<double>(now_ns()) + rng.uniform() * w.meanGapNs;
+    std::uint64_t localCount = 0;
+    for (;;) {
+        w.progress->store(localCount, std::memory_order_relaxed);
+        const std::uint64_t due = static_cast<std::uint64_t>(arrival);
+        bool stopped = false;
+        while (now_ns() < due) {
+            if ((stopped = w.timing->stop.load(std::memory_order_acquire))) break;
+            cpu_relax_once();
+        }
+        if (stopped || w.timing->stop.load(std::memory_order_acquire)) break;
+
+        C::run_parallel(env.task);
+        if (env.keys) {
+            const int k = env.keys->pick(rng.next());
+            critical_section<Lock, Task, RecordLatency>(env.stripes->at(static_cast<std::size_t>(k)), env.task, k, w);
+        } else {
+            critical_section<Lock, Task, RecordLatency>(env.lock, env.task, -1, w);
+        }
+        w.response->record(now_ns() - due);
+        ++localCount;
+        arrival += gap();
+    }
+    return localCount;
+}
+
+template <class Lock, class Task>
+std::uint64_t open_loop_worker_entry(void* env, WorkerCtx& w) {
+    auto* e = static_cast<LoopEnv<Lock, Task>*>(env);
+    return w.latency ? open_loop_worker_loop<Lock, Task, true>(*e, w)
+                     : open_loop_worker_loop<Lock, Task, false>(*e, w);
+}
+
+// Handover loop: the owner stamps the TSC into the protected state right before unlock(),
+// and the next owner, right after lock() returns, records now minus that stamp. Only true
+// handovers count: the previous owner is another thread and released while this one was
+// already waiting (release stamp after our pre-lock stamp); an acquisition of an idle lock
+// says nothing about how fast it passes ownership. Both stamps are unserialized TSC reads
+// on different CPUs, so values below the measured cross-core skew are noise.
+template <class Lock, class Task>
+std::uint64_t handover_worker_loop(Lock* lock, Task* task, HandoverStamp& stamp, WorkerCtx& w) {
+    using C = Calls<Lock, Task>;
+    const double nsPerTick = tsc_calibration().nsPerTick;
+    auto ns = [nsPerTick](std::uint64_t ticks) { return static_cast<std::uint64_t>(static_cast<double>(ticks) * nsPerTick); };
+    std::uint64_t localCount = 0;
+    const int checkEvery = 64;
+    for (;;) {
+        if ((localCount & (checkEvery - 1)) == 0) {
+            w.progress->store(localCount, std::memory_order_relaxed);
+            if (w.timing->stop.load(std::memory_order_acquire)) {
+                break;
+            }
+        }
+        C::run_parallel(task);
+
+        const std::uint64_t t0 = tsc_now();
+        C::lock(lock);
+        const std::uint64_t t1 = tsc_now();
+        const std::uint64_t released = stamp.releaseTicks;
+        if (stamp.owner >= 0 && stamp.owner != w.slot && released > t0 && t1 > released) {
+            w.handover->record(ns(t1 - released));
+        }
+        if (w.latency) w.latency->record(ns(t1 - t0));
+        C::run_locked(task);
+        stamp.owner = w.slot;
+        stamp.releaseTicks = tsc_now();
+        C::unlock(lock);
+        ++localCount;
+    }
+    return localCount;
+}
+
+template <class Lock, class Task>
+std::uint64_t handover_worker_entry(void* env, WorkerCtx& w) {
+    auto* e = static_cast<LoopEnv<Lock, Task>*>(env);
+    return handover_worker_loop<Lock, Task>(e->lock, e->task, *e->handover, w);
+}
+
+} // namespace detail
+
+// Type-erased handle so callers can drive virtual and devirtualized runners alike.
+class iTestRunner {
+public:
+    virtual ~iTestRunner() = default;
+    virtual RunResult run_test() = 0;
+    // Unmeasured run of the same lock and task for `seconds` (no latency or perf counters);
+    // brings pool threads, caches and lock state to steady state before the repeats.
+    virtual void warm_up(double seconds) = 0;
+};
+
+// Runner over a lock type and a task type. With the interface types (LockTestSys below)
+// every call in the worker loop is virtual; with concrete types each (lock, task) pair
+// gets its own fully inlined loop.
+template <class Lock, class Task>
+class BasicLockTestSys : public iTestRunner {
 public:
-    LockTestSys(std::unique_ptr<iLock> lock,
-                std::unique_ptr<iRunTask> task,
-                int numThreads,
-                double durationSeconds)
-        : lock_(std::move(lock)), task_(std::move(task)), numThreads_(numThreads), durationSeconds_(durationSeconds) {}
+    BasicLockTestSys(std::unique_ptr<Lock> lock,
+                     std::unique_ptr<Task> task,
+                     int numThreads,
+                     double durationSeconds,
+                     RunOptions options = {})
+        : single_(std::move(lock)), task_(std::move(task)), numThreads_(numThreads),
+          durationSeconds_(durationSeconds), options_(std::move(options)) {}
 
-    // Run with lock for a fixed duration; threads compete for lock and call task->run().
-    // Returns total operations completed across all threads.
-    std::uint64_t run_test();
+    // Runner over an arena of lock instances; with more than one, each iteration picks a
+    // stripe via options.keys (striped / many-locks mode).
+    BasicLockTestSys(LockArena<Lock> locks,
+                     std::unique_ptr<Task> task,
+                     int numThreads,
+                     double durationSeconds,
+                     RunOptions options = {})
+        : locks_(std::move(locks)), task_(std::move(task)), numThreads_(numThreads),
+          durationSeconds_(durationSeconds), options_(std::move(options)) {
+        if (locks_.size() > 1) keys_ = std::make_unique<KeyTable>(options_.keys, static_cast<int>(locks_.size()));
+    }
 
-    // No atomic-only path in this mode.
+    // Run with lock for a fixed duration (or options.opsPerThread rounds per thread); threads
+    // compete for lock and call task->run(). Returns total operations completed across all
+    // threads plus optional latency data.
+    RunResult run_test() override { return run_for(durationSeconds_, options_); }
+
+    void warm_up(double seconds) override {
+        RunOptions quiet = options_;
+        quiet.recordLatency = false;
+        quiet.perf.enabled = false;
+        quiet.sampleIntervalMs = 0.0;
+        quiet.opsPerThread = 0; // warm-up is always a time window
+        (void)run_for(seconds, quiet);
+    }
 
     int threads() const { return numThreads_; }
+    int stripes() const { return single_ ? 1 : static_cast<int>(locks_.size()); }
     double durationSeconds() const { return durationSeconds_; }
+    const RunOptions& options() const { return options_; }
 
 private:
-    std::unique_ptr<iLock> lock_;
-    std::unique_ptr<iRunTask> task_;
+    RunResult run_for(double seconds, const RunOptions& options) {
+        assert((single_ || !locks_.empty()) && task_);
+        task_->reset();
+        handover_ = detail::HandoverStamp{};
+        Lock* first = single_ ? single_.get() : locks_.at(0);
+        detail::LoopEnv<Lock, Task> env{first, task_.get(), &locks_, keys_.get(), &handover_};
+        std::uint64_t valueBefore = 0;
+        if constexpr (std::is_base_of_v<iAtomicBaseline, Lock>) valueBefore = baseline_value();
+        RunResult r = detail::run_harness(numThreads_, seconds, options, select_loop(options), &env, task_.get());
+        if constexpr (std::is_base_of_v<iAtomicBaseline, Lock>) {
+            // value() is cumulative (never reset), so the run's share is the difference
+            r.baselineCount = static_cast<std::int64_t>(baseline_value() - valueBefore);
+        } else {
+            // baselines never run the task's critical section
+            if (const SharedDataTask* sd = as_shared_data(task_.get())) r.lockedCount = static_cast<std::int64_t>(sd->locked_count());
+        }
+        return r;
+    }
+
+    // Sum of value() over every instance (striped runs spread the updates).
+    std::uint64_t baseline_value() const {
+        if (single_) return single_->value();
+        std::uint64_t v = 0;
+        for (std::size_t k = 0; k < locks_.size(); ++k) v += locks_.at(k)->value();
+        return v;
+    }
+
+    static const SharedDataTask* as_shared_data(const Task* t) {
+        if constexpr (std::is_same_v<Task, SharedDataTask>) {
+            return t;
+        } else if constexpr (std::is_base_of_v<Task, SharedDataTask>) {
+            return dynamic_cast<const SharedDataTask*>(t);
+        } else {
+            return nullptr;
+        }
+    }
+
+    detail::LoopFn select_loop(const RunOptions& options) const {
+        if (options.opsPerThread > 0) return &detail::counted_worker_entry<Lock, Task>;
+        // delegation engines and lock-free baselines have no unlock() -> lock() handover
+        if constexpr (!std::is_base_of_v<iDelegationLock, Lock> && !std::is_base_of_v<iAtomicBaseline, Lock>) {
+            if (options.recordHandover) return &detail::handover_worker_entry<Lock, Task>;
+        }
+        if (options.arrivalRate > 0.0) return &detail::open_loop_worker_entry<Lock, Task>;
+        if constexpr (std::is_base_of_v<iRWLock, Lock>) {
+            if (options.readRatio >= 0.0) return &detail::rw_worker_entry<Lock, Task>;
+        }
+        if (keys_) return &detail::striped_worker_entry<Lock, Task>;
+        return &detail::worker_entry<Lock, Task>;
+    }
+
+    std::unique_ptr<Lock> single_;             // single-lock constructor
+    LockArena<Lock> locks_;                    // arena constructor: one entry unless striped
+    std::unique_ptr<KeyTable> keys_;           // striped: read-only stripe sampling table
+    detail::HandoverStamp handover_;           // handover loop: reset before every run
+    std::unique_ptr<Task> task_;
     int numThreads_ {4};
     double durationSeconds_ {1.0};
+    RunOptions options_ {};
 };
 
+// Virtual-dispatch runner (the historical path).
+using LockTestSys = BasicLockTestSys<iLock, iRunTask>;
+
+// Virtual-dispatch runner for the reader-writer loop.
+using RWLockTestSys = BasicLockTestSys<iRWLock, iRunTask>;
+
+// Virtual-dispatch runner for delegation engines (critical sections go through execute()).
+using DelegationLockTestSys = BasicLockTestSys<iDelegationLock, iRunTask>;
+
+// Virtual-dispatch runner for lock-free baselines (update() instead of the critical section).
+using AtomicBaselineTestSys = BasicLockTestSys<iAtomicBaseline, iRunTask>;
+
 } // namespace lt
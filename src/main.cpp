@@ -8,41 +8,171 @@
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <map>
 
-#include "locks/StdMutexLock.h"
-#include "locks/TasSpinlock.h"
-#include "locks/TicketLock.h"
-#include "locks/McsLock.h"
 #include "lockTestSys.h"
+#include "registry.h"
+#include "locks/ElisionLock.h"
+#include "locks/ProfiledLock.h"
+#include "SpinWait.h"
+#include "sampleStats.h"
+#include "topology.h"
+#include "tscTimer.h"
+#include "memUsage.h"
+#include "keyDistribution.h"
+#include "workerPool.h"
+#include "resultsJson.h"
 
 using namespace lt;
 
+// --group n:task[:p[:l[:placement]]] 一个线程组：线程数、任务、并行/加锁迭代、可选绑核
+struct GroupSpec {
+    TaskGroup group;
+    std::string placement; // 空 = 沿用 --placement 为整体分配的 CPU
+    std::string spec;      // 原始参数，用于输出
+};
+
 struct Args {
     // 任务类型、锁列表、分段线程集、重复次数、时长、cpu_burn 比例、CSV 文件输出、是否仅 CSV
     std::string runTask = "cpu_burn";   // 支持 cpu_burn | do_nothing（可扩展）
     std::vector<std::string> locks;     // -L mutex,spin,ticket,mcs
     std::string threadBins;             // -B 1-64:1,65-128:8
-    int repeats = 5;                    // -n 重复次数
+    std::vector<GroupSpec> groups;      // --group 异构线程组（替代 -B 与 -r，线程数为各组之和）
+    int repeats = 5;                    // -n 重复次数（自适应模式下为最少次数）
+    double warmup = 0.0;                // --warmup 每个（锁, 线程数）点正式计数前的预热时长（秒），不计入结果
+    double ciTarget = 0.0;              // --ci-target 自适应重复：95% 置信区间半宽 / 均值 低于该值即停止（0 = 固定 -n 次）
+    int maxRepeats = 30;                // --max-repeats 自适应重复的上限
     double duration = 2.0;              // -d 每组时长（秒）
+    std::uint64_t ops = 0;              // --ops N 固定轮数模式：每线程恰好 N 轮，替代 -d（计时从首个线程开始到最后一个结束）
     int cpuParallelIters = 2048;        // -R p[:l] 并行迭代
     int cpuLockedIters = 32;            // -R p[:l] 加锁迭代
     std::string csvFile;                // --csv-file 输出 CSV 文件
     bool csvOnly = false;               // --csv-only 仅 CSV
+    std::string jsonFile;               // --json-file 结果 JSON：环境指纹 + 每个运行点的逐次重复样本（供 compare 使用）
+    bool latency = false;               // --latency 记录每次 lock() 等待时间（直方图分位数）
+    bool handover = false;              // --handover 记录锁移交延迟（unlock() 到下一持有者 lock() 返回，TSC 计时）
+    std::string placement = "rr";       // --placement rr|compact|scatter|core|node:<ids>|list:<cpus>
+    unsigned cohortBatch = 64;          // --cohort-batch cohort 锁节点内连续移交上限
+    unsigned spinBudget = 128;          // --spin-budget futex_adaptive / mcs_park 自旋轮数上限
+    BackoffParams backoff;              // --backoff base[:max[:yield]] 退避策略参数（spin@/ticket@ 变体）
+    ElisionPolicy elision;              // --elision retries[:hint|fixed] elide:<lock> 的事务重试策略
+    int sharedLines = 4;                // --shared-lines shared_data 临界区写入的共享缓存行数
+    long privateBytes = 4096;           // --private-bytes shared_data 每线程私有工作集字节数
+    std::size_t memBytes = 32768;       // --mem-bytes mem_stream/mem_chase 每线程缓冲区大小（支持 k/m/g 后缀）
+    int memLines = 64;                  // --mem-lines mem_stream/mem_chase 每次 run_parallel 访问的缓存行数
+    bool hugePages = false;             // --huge-pages mem_stream/mem_chase 缓冲区使用大页
+    double readRatio = -1.0;            // --read-ratio 读写锁模式：每轮以该概率取读锁（<0 为独占模式）
+    PerfConfig perf;                    // --perf / --perf-raw 每线程 perf_event_open 计数器
+    double sampleMs = 0.0;              // --sample-ms 运行内吞吐时间序列的采样间隔（毫秒，0 = 关闭）
+    std::string sampleFile;             // --sample-file 时间序列输出（长格式 CSV）
+    std::vector<int> stripes {1};       // --stripes 1,4,16 条带模式：每个运行点使用 K 个锁实例（可为区间列表）
+    LockLayout layout = LockLayout::Line; // --lock-layout line|packed 条带锁实例间距：每锁独占缓存行 / 紧凑排列
+    std::vector<KeySpec> keys {KeySpec{}}; // --keys uniform,zipf:<s>,hotspot:<p>[:<h>] 条带选择分布
+    std::vector<double> rates;          // --rate 开环模式：总到达率（ops/s）列表，逐个扫描（空 = 闭环）
+    ArrivalProcess arrivals = ArrivalProcess::Poisson; // --arrivals poisson|fixed 开环到达过程
+    bool pool = true;                   // --no-pool 关闭常驻线程池，每次运行重新创建/join 线程
+    std::string dispatch = "virtual";   // --dispatch virtual|static 虚调用 / 按类型实例化的内联循环
+    bool processes = false;             // --processes 跨进程模式：锁与共享数据放在共享内存，每个 worker 为 fork 出的绑核进程
+    bool profile = false;               // --profile 每个锁之后追加 prof:<锁> 运行点：争用计数、等待/持有时间与装饰器开销
+    WaitConfig wait {kDefaultWaitKernel, 0}; // --wait-kernel k[:ticks] 自旋等待内核（0 ticks = 该内核默认值）
 };
 
+static std::string join_names(const std::vector<std::string>& v) {
+    std::string s;
+    for (size_t i = 0; i < v.size(); ++i) s += (i ? "," : "") + v[i];
+    return s;
+}
+
 static void print_usage(const char* prog) {
     std::cout << "Usage:\n"
               << "  " << prog << " -r <task> -L mutex,spin,ticket,mcs \\\n" 
               << "    -B 1-64:1,65-128:8 -n 5 -d 1.0 -R 2048:32 \\\n" 
-              << "    --csv-file results.csv [--csv-only]\n";
-    std::cout << "  -r task       task kind: cpu_burn | do_nothing\n";
-    std::cout << "  -L locks      comma-separated locks: mutex,spin,ticket,mcs\n";
+              << "    --csv-file results.csv [--csv-only] [--json-file results.json]\n"
+              << "  " << prog << " compare base.json new.json [--threshold r]\n";
+    std::cout << "  -r task       task kind: " << join_names(task_names()) << "\n";
+    std::cout << "  -L locks      comma-separated locks: " << join_names(lock_names()) << "\n";
+    std::cout << "                back-off policies: spin|spin_preload|ticket|ticket_pf @ none|const|prop|exp|rexp\n";
     std::cout << "  -B bins       thread bins: e.g. 1-64:1,65-128:8 (inclusive; step default=1)\n";
+    std::cout << "  --group n:task[:p[:l[:placement]]]  repeatable, replaces -B and -r: a group of n threads\n"
+              << "                running its own task with p parallel / l locked iterations, optionally on its\n"
+              << "                own CPUs (e.g. --group 4:cpu_burn:64:512 --group 60:cpu_burn:2048:8:node:1);\n"
+              << "                throughput and latency are also reported per group\n";
     std::cout << "  -n repeats    repeats per setting (default 5)\n";
     std::cout << "  -d seconds    duration per run in seconds (default 2.0)\n";
+    std::cout << "  --ops N       instead of -d: every thread runs exactly N rounds, timed from the first\n"
+              << "                start to the last finish (ns/op and TSC ticks/op columns)\n";
+    std::cout << "  --warmup s    unmeasured warm-up run of s seconds before each (lock, threads) point\n";
+    std::cout << "  --ci-target r adaptive repeats: stop once the 95% CI half-width of ops/s is within r\n"
+              << "                of the mean (e.g. 0.02); -n becomes the minimum\n";
+    std::cout << "  --max-repeats n   adaptive repeats: upper bound (default 30)\n";
     std::cout << "  -R p[:l]      cpu_burn iters: parallel p, locked l (default 2048:32)\n";
+    std::cout << "  --shared-lines n  shared_data: shared cache lines read+written under the lock (default 4)\n";
+    std::cout << "  --private-bytes b shared_data: private working set per thread outside the lock (default 4096)\n";
+    std::cout << "  --mem-bytes b     mem_stream/mem_chase: per-thread buffer, k/m/g suffixes (default 32k)\n";
+    std::cout << "  --mem-lines n     mem_stream/mem_chase: cache lines touched per iteration outside the lock\n"
+              << "                (default 64); the locked part is -R's l scramble rounds\n";
+    std::cout << "  --huge-pages      mem_stream/mem_chase: MAP_HUGETLB buffers (falls back to transparent huge pages)\n";
     std::cout << "  --csv-file f  write CSV to file path f (with header)\n";
     std::cout << "  --csv-only    suppress formatted table (CSV only)\n";
+    std::cout << "  --json-file f also write f: environment fingerprint (CPU, microcode, kernel, governor, turbo,\n"
+              << "                compiler flags) and every repeat's ops/s and latency percentiles per point\n";
+    std::cout << "  compare a b   compare two --json-file results per (lock, threads, ...) point: Welch t-test\n"
+              << "                (95%) on each series, rows for changes >= --threshold (default 0.02);\n"
+              << "                exit status 1 when a significant regression is found\n";
+    std::cout << "  --placement p thread pinning: rr (default) | compact | scatter | core |\n"
+              << "                node:<ids> | list:<cpus> (e.g. list:0,2,4-7)\n";
+    std::cout << "  --cohort-batch n  cohort lock: max consecutive same-node handovers (default 64)\n";
+    std::cout << "  --spin-budget n   futex_adaptive/mcs_park: spin rounds before parking (default 128)\n";
+    std::cout << "  --backoff b[:m[:y]]  back-off params for <lock>@<policy> locks: base b, cap m, yield when\n"
+              << "                more than y tickets ahead (0 = never); default 4:1024:20\n";
+    std::cout << "  --wait-kernel k[:t]  what every spin loop runs per round: default (each loop as before: PAUSE\n"
+              << "                where it paused, empty where it was empty) | pause | spin | tpause | umwait\n"
+              << "                (x86 WAITPKG, t = TSC ticks per wait) | yield | wfe (Arm) | auto; unsupported\n"
+              << "                kernels fall back to the default (wait_kernel column shows the active one)\n";
+    std::cout << "  --elision r[:p]  elide:<lock>: r transactional attempts before the real lock (default 3);\n"
+              << "                p = hint (default, stop on aborts without the RETRY hint) | fixed (always r)\n";
+    std::cout << "  --profile     after every lock also run prof:<lock> (contention-profiling decorator): contended\n"
+              << "                fraction, wait and hold ns per acquisition, throughput overhead vs the bare lock\n";
+    std::cout << "  --read-ratio r    reader-writer mode for rw_* locks: each iteration reads with probability r\n";
+    std::cout << "  --dispatch m  worker loop dispatch: virtual (default) | static (per-type inlined loop)\n";
+    std::cout << "  --processes   workers are forked, pinned processes; the lock and shared_data's shared lines\n"
+              << "                live in a shm_open/mmap region (process-shared locks only: spin*, spin_preload*,\n"
+              << "                ticket*, futex_shm, futex_adaptive_shm, mcs_shm, mutex_shm)\n";
+    std::cout << "  --perf        per-thread perf_event_open counters inside the window (per-op columns)\n";
+    std::cout << "  --perf-raw x  additionally count raw PMU event x (hex, e.g. 0x04d2 = HITM on Skylake-SP)\n";
+    std::cout << "  --sample-ms t   sample per-thread progress every t ms inside each run (time series)\n";
+    std::cout << "  --sample-file f long-format CSV for --sample-ms (task,lock,...,t_ms,thread,ops_s)\n";
+    std::cout << "  --stripes K   striped mode: K lock instances, one picked per iteration (list/ranges like -B)\n";
+    std::cout << "  --lock-layout l   stripe arena layout: line (default, one cache line per lock) | packed\n"
+              << "                (sizeof rounded to alignof; rss_bytes_per_lock reports the resident cost)\n";
+    std::cout << "  --keys d      stripe distributions, comma-separated: uniform | zipf:<s> | hotspot:<p>[:<h>]\n";
+    std::cout << "  --rate r      open-loop mode: aggregate offered ops/s, comma-separated list = load sweep\n"
+              << "                (e.g. 1e5,2e5,4e5); latency is measured from the scheduled arrival\n";
+    std::cout << "  --arrivals a  open-loop arrival process: poisson (default) | fixed\n";
+    std::cout << "  --no-pool     create and join worker threads per run instead of reusing a pinned pool\n";
+    std::cout << "  --latency     record per-acquisition lock() wait time (p50/p90/p99/p99.9/max columns)\n";
+    std::cout << "  --handover    stamp release/acquire (calibrated TSC) in the protected state and report the\n"
+              << "                unlock() -> next owner's lock() return latency (handover_* columns)\n";
+}
+
+static std::vector<int> parse_bins(const std::string& spec);
+
+// 字节数，可带 k/m/g 后缀（1024 进制），如 32k、1g
+static bool parse_bytes(const std::string& s, std::size_t& out) {
+    std::size_t pos = 0;
+    unsigned long long v = 0;
+    try {
+        v = std::stoull(s, &pos);
+    } catch (...) {
+        return false;
+    }
+    std::string suffix = s.substr(pos);
+    if (suffix == "k" || suffix == "K") v <<= 10;
+    else if (suffix == "m" || suffix == "M") v <<= 20;
+    else if (suffix == "g" || suffix == "G") v <<= 30;
+    else if (!suffix.empty()) return false;
+    out = static_cast<std::size_t>(v);
+    return true;
 }
 
 static bool parse_args(int argc, char** argv, Args& out) {
@@ -50,6 +180,31 @@ static bool parse_args(int argc, char** argv, Args& out) {
         std::string a = argv[i];
         if (a == "-B" && i + 1 < argc) {
             out.threadBins = argv[++i];
+        } else if (a == "--group" && i + 1 < argc) {
+            GroupSpec g;
+            g.spec = argv[++i];
+            g.group.parallelIters = -1;
+            g.group.lockedIters = -1;
+            // 前四个字段以 ':' 分隔，其余整体作为绑核策略（自身可含 ':'）
+            std::vector<std::string> f;
+            size_t pos = 0;
+            while (f.size() < 4) {
+                size_t c = g.spec.find(':', pos);
+                f.push_back(g.spec.substr(pos, c == std::string::npos ? std::string::npos : c - pos));
+                if (c == std::string::npos) { pos = std::string::npos; break; }
+                pos = c + 1;
+            }
+            if (pos != std::string::npos) g.placement = g.spec.substr(pos);
+            g.group.threads = std::atoi(f[0].c_str());
+            if (f.size() > 1) g.group.task = f[1];
+            if (f.size() > 2 && !f[2].empty()) g.group.parallelIters = std::atoi(f[2].c_str());
+            if (f.size() > 3 && !f[3].empty()) g.group.lockedIters = std::atoi(f[3].c_str());
+            if (g.group.threads <= 0 || f.size() < 2 || !is_known_task(g.group.task)) {
+                std::cerr << "Invalid --group: " << g.spec << " (n:task[:p[:l[:placement]]], tasks: "
+                          << join_names(task_names()) << ")" << "\n";
+                return false;
+            }
+            out.groups.push_back(g);
         } else if (a == "-L" && i + 1 < argc) {
             std::string v = argv[++i];
             std::stringstream ss(v);
@@ -63,6 +218,24 @@ static bool parse_args(int argc, char** argv, Args& out) {
             out.repeats = std::atoi(argv[++i]);
         } else if (a == "-d" && i + 1 < argc) {
             out.duration = std::atof(argv[++i]);
+        } else if (a == "--ops" && i + 1 < argc) {
+            try {
+                out.ops = std::stoull(argv[++i]);
+            } catch (...) {
+                out.ops = 0;
+            }
+            if (out.ops == 0) {
+                std::cerr << "Invalid --ops count: " << argv[i] << "\n";
+                return false;
+            }
+        } else if (a == "--warmup" && i + 1 < argc) {
+            out.warmup = std::atof(argv[++i]);
+            if (out.warmup < 0.0) out.warmup = 0.0;
+        } else if (a == "--ci-target" && i + 1 < argc) {
+            out.ciTarget = std::atof(argv[++i]);
+            if (out.ciTarget < 0.0) out.ciTarget = 0.0;
+        } else if (a == "--max-repeats" && i + 1 < argc) {
+            out.maxRepeats = std::atoi(argv[++i]);
         } else if (a == "-R" && i + 1 < argc) {
             std::string v = argv[++i];
             // 支持 "p:l" 或 "p,l" 或仅 "p"
@@ -84,10 +257,175 @@ static bool parse_args(int argc, char** argv, Args& out) {
             parse_pair(v, p, l);
             if (p > 0) out.cpuParallelIters = p; else out.cpuParallelIters = 2048;
             if (l > 0) out.cpuLockedIters = l; else if (l == -1) {/* keep default */}
+        } else if (a == "--shared-lines" && i + 1 < argc) {
+            out.sharedLines = std::atoi(argv[++i]);
+            if (out.sharedLines <= 0) out.sharedLines = 4;
+        } else if (a == "--private-bytes" && i + 1 < argc) {
+            out.privateBytes = std::atol(argv[++i]);
+            if (out.privateBytes < 0) out.privateBytes = 4096;
+        } else if (a == "--mem-bytes" && i + 1 < argc) {
+            if (!parse_bytes(argv[++i], out.memBytes) || out.memBytes < 64) {
+                std::cerr << "Invalid --mem-bytes: " << argv[i] << " (at least 64)" << "\n";
+                return false;
+            }
+        } else if (a == "--mem-lines" && i + 1 < argc) {
+            out.memLines = std::atoi(argv[++i]);
+            if (out.memLines <= 0) out.memLines = 64;
+        } else if (a == "--huge-pages") {
+            out.hugePages = true;
         } else if (a == "--csv-only") {
             out.csvOnly = true;
         } else if (a == "--csv-file" && i + 1 < argc) {
             out.csvFile = argv[++i];
+        } else if (a == "--json-file" && i + 1 < argc) {
+            out.jsonFile = argv[++i];
+        } else if (a == "--placement" && i + 1 < argc) {
+            out.placement = argv[++i];
+        } else if (a == "--cohort-batch" && i + 1 < argc) {
+            int v = std::atoi(argv[++i]);
+            out.cohortBatch = (v >= 0) ? static_cast<unsigned>(v) : 64u;
+        } else if (a == "--spin-budget" && i + 1 < argc) {
+            int v = std::atoi(argv[++i]);
+            out.spinBudget = (v >= 0) ? static_cast<unsigned>(v) : 128u;
+        } else if (a == "--backoff" && i + 1 < argc) {
+            // base[:max[:yield]]，省略的字段保持默认
+            std::stringstream ss(argv[++i]);
+            std::string item;
+            unsigned* fields[] = { &out.backoff.base, &out.backoff.max, &out.backoff.yieldAfter };
+            for (unsigned* f : fields) {
+                if (!std::getline(ss, item, ':')) break;
+                int v = std::atoi(item.c_str());
+                if (v >= 0) *f = static_cast<unsigned>(v);
+            }
+        } else if (a == "--wait-kernel" && i + 1 < argc) {
+            // kernel[:ticks]
+            std::string v = argv[++i];
+            const size_t colon = v.find(':');
+            if (!parse_wait_kernel(v.substr(0, colon), out.wait.kernel)) {
+                std::cerr << "Unsupported --wait-kernel: " << v << ", supported: default, spin, pause, tpause, umwait, yield, wfe, auto"
+                          << "\n";
+                return false;
+            }
+            if (colon != std::string::npos) {
+                const long t = std::atol(v.substr(colon + 1).c_str());
+                if (t <= 0 || t > 0xffffffffL) {
+                    std::cerr << "Invalid --wait-kernel ticks: " << v << "\n";
+                    return false;
+                }
+                out.wait.ticks = static_cast<std::uint32_t>(t);
+            }
+        } else if (a == "--elision" && i + 1 < argc) {
+            // retries[:hint|fixed]
+            std::string v = argv[++i];
+            const size_t colon = v.find(':');
+            const int r = std::atoi(v.substr(0, colon).c_str());
+            if (r < 0) {
+                std::cerr << "Invalid --elision retries: " << v << "\n";
+                return false;
+            }
+            out.elision.retries = static_cast<unsigned>(r);
+            if (colon != std::string::npos) {
+                const std::string mode = v.substr(colon + 1);
+                if (mode == "hint") {
+                    out.elision.followHints = true;
+                } else if (mode == "fixed") {
+                    out.elision.followHints = false;
+                } else {
+                    std::cerr << "Unsupported --elision policy: " << mode << ", supported: hint, fixed" << "\n";
+                    return false;
+                }
+            }
+        } else if (a == "--read-ratio" && i + 1 < argc) {
+            out.readRatio = std::atof(argv[++i]);
+            if (out.readRatio < 0.0 || out.readRatio > 1.0) {
+                std::cerr << "--read-ratio must be within [0, 1]" << "\n";
+                return false;
+            }
+        } else if (a == "--dispatch" && i + 1 < argc) {
+            out.dispatch = argv[++i];
+        } else if (a == "--perf") {
+            out.perf.enabled = true;
+        } else if (a == "--perf-raw" && i + 1 < argc) {
+            // 原始 PMU 事件编码（x86: umask << 8 | event），隐含 --perf
+            try {
+                out.perf.rawConfig = std::stoull(argv[++i], nullptr, 0);
+            } catch (...) {
+                std::cerr << "Invalid --perf-raw event code: " << argv[i] << "\n";
+                return false;
+            }
+            out.perf.haveRaw = true;
+            out.perf.enabled = true;
+        } else if (a == "--sample-ms" && i + 1 < argc) {
+            out.sampleMs = std::atof(argv[++i]);
+            if (out.sampleMs < 0.0) out.sampleMs = 0.0;
+        } else if (a == "--sample-file" && i + 1 < argc) {
+            out.sampleFile = argv[++i];
+        } else if (a == "--stripes" && i + 1 < argc) {
+            out.stripes = parse_bins(argv[++i]);
+            if (out.stripes.empty()) {
+                std::cerr << "Invalid --stripes spec: " << argv[i] << "\n";
+                return false;
+            }
+        } else if (a == "--lock-layout" && i + 1 < argc) {
+            std::string v = argv[++i];
+            if (v == "line") {
+                out.layout = LockLayout::Line;
+            } else if (v == "packed") {
+                out.layout = LockLayout::Packed;
+            } else {
+                std::cerr << "Unsupported --lock-layout: " << v << ", supported: line, packed" << "\n";
+                return false;
+            }
+        } else if (a == "--keys" && i + 1 < argc) {
+            out.keys.clear();
+            std::stringstream ss(argv[++i]);
+            std::string item, err;
+            while (std::getline(ss, item, ',')) {
+                KeySpec ks;
+                if (!parse_key_spec(item, ks, err)) {
+                    std::cerr << "Invalid --keys: " << err << "\n";
+                    return false;
+                }
+                out.keys.push_back(ks);
+            }
+            if (out.keys.empty()) out.keys.push_back(KeySpec{});
+        } else if (a == "--rate" && i + 1 < argc) {
+            out.rates.clear();
+            std::stringstream ss(argv[++i]);
+            std::string item;
+            while (std::getline(ss, item, ',')) {
+                double r = 0.0;
+                try {
+                    r = std::stod(item);
+                } catch (...) {
+                    r = 0.0;
+                }
+                if (r <= 0.0) {
+                    std::cerr << "Invalid --rate value: " << item << "\n";
+                    return false;
+                }
+                out.rates.push_back(r);
+            }
+        } else if (a == "--arrivals" && i + 1 < argc) {
+            std::string v = argv[++i];
+            if (v == "poisson") {
+                out.arrivals = ArrivalProcess::Poisson;
+            } else if (v == "fixed") {
+                out.arrivals = ArrivalProcess::Fixed;
+            } else {
+                std::cerr << "Unsupported --arrivals: " << v << ", supported: poisson, fixed" << "\n";
+                return false;
+            }
+        } else if (a == "--no-pool") {
+            out.pool = false;
+        } else if (a == "--processes") {
+            out.processes = true;
+        } else if (a == "--profile") {
+            out.profile = true;
+        } else if (a == "--latency") {
+            out.latency = true;
+        } else if (a == "--handover") {
+            out.handover = true;
         } else if (a == "-h" || a == "--help") {
             print_usage(argv[0]);
             return false;
@@ -99,16 +437,94 @@ static bool parse_args(int argc, char** argv, Args& out) {
     }
     if (out.duration <= 0.0) out.duration = 1.0;
     if (out.repeats <= 0) out.repeats = 1;
-    // 允许 cpu_burn / do_nothing；其他任务名暂不支持
-    if (!(out.runTask == "cpu_burn" || out.runTask == "do_nothing")) {
-        std::cerr << "Unsupported task: " << out.runTask << ", supported: cpu_burn, do_nothing" << "\n";
+    // 自适应模式至少需要两次才有方差
+    if (out.ciTarget > 0.0 && out.repeats < 2) out.repeats = 2;
+    if (out.maxRepeats < out.repeats) out.maxRepeats = out.repeats;
+    // 任务名需在 registry 中注册
+    if (!is_known_task(out.runTask)) {
+        std::cerr << "Unsupported task: " << out.runTask << ", supported: " << join_names(task_names()) << "\n";
         return false;
     }
+    // 无锁基线把临界区换成一次原子自增，只有加锁路径同样只写一个计数器的任务才可比
+    const bool singleIncrement = out.runTask == "do_nothing" || (out.runTask == "shared_data" && out.sharedLines == 1);
+    for (const auto& lk : out.locks) {
+        if (is_atomic_baseline(lk) && (!singleIncrement || !out.groups.empty())) {
+            std::cerr << lk << " replaces the critical section with one atomic increment; use it with -r do_nothing or "
+                      << "-r shared_data --shared-lines 1" << "\n";
+            return false;
+        }
+    }
+    if (!(out.dispatch == "virtual" || out.dispatch == "static")) {
+        std::cerr << "Unsupported --dispatch: " << out.dispatch << ", supported: virtual, static" << "\n";
+        return false;
+    }
+    {
+        Placement pl;
+        std::string err;
+        if (!parse_placement(out.placement, pl, err)) {
+            std::cerr << "Invalid --placement: " << err << "\n";
+            return false;
+        }
+    }
     if (out.locks.empty()) {
         std::cerr << "Locks list (-L) is required" << "\n";
         return false;
     }
-    if (out.threadBins.empty()) {
+    // 服务线程型委托锁（rcl）每个实例自带一个不绑核、持续轮询的服务线程，K 个条带就是 K 个服务线程
+    if (std::any_of(out.stripes.begin(), out.stripes.end(), [](int k) { return k > 1; })) {
+        for (const auto& lk : out.locks) {
+            if (owns_server_thread(lk)) {
+                std::cerr << "--stripes > 1 cannot be combined with server delegation locks (one server thread per instance): "
+                          << lk << "\n";
+                return false;
+            }
+        }
+    }
+    if (out.readRatio >= 0.0) {
+        if (std::any_of(out.stripes.begin(), out.stripes.end(), [](int k) { return k > 1; })) {
+            std::cerr << "--read-ratio cannot be combined with --stripes > 1" << "\n";
+            return false;
+        }
+        if (!out.rates.empty()) {
+            std::cerr << "--read-ratio cannot be combined with --rate" << "\n";
+            return false;
+        }
+        for (const auto& lk : out.locks) {
+            if (!is_rw_lock(lk)) {
+                std::cerr << "--read-ratio needs reader-writer locks (rw_*), got: " << lk << "\n";
+                return false;
+            }
+        }
+    }
+    if (!out.groups.empty()) {
+        if (!out.threadBins.empty()) {
+            std::cerr << "--group replaces -B; give one or the other" << "\n";
+            return false;
+        }
+        if (out.dispatch != "virtual") {
+            std::cerr << "--group needs --dispatch virtual (one task instance per group)" << "\n";
+            return false;
+        }
+        for (const auto& lk : out.locks) {
+            if (is_delegation_lock(lk)) {
+                std::cerr << "--group cannot be combined with delegation locks (the combiner runs other groups' sections): "
+                          << lk << "\n";
+                return false;
+            }
+        }
+        for (auto& g : out.groups) {
+            Placement pl;
+            std::string err;
+            if (!g.placement.empty() && !parse_placement(g.placement, pl, err)) {
+                std::cerr << "Invalid --group placement: " << err << "\n";
+                return false;
+            }
+            // 省略的迭代数沿用 -R
+            if (g.group.parallelIters < 0) g.group.parallelIters = out.cpuParallelIters;
+            if (g.group.lockedIters < 0) g.group.lockedIters = out.cpuLockedIters;
+        }
+        out.runTask = "group";
+    } else if (out.threadBins.empty()) {
         std::cerr << "Thread bins (-B) is required" << "\n";
         return false;
     }
@@ -116,6 +532,59 @@ static bool parse_args(int argc, char** argv, Args& out) {
         std::cerr << "--csv-file is required" << "\n";
         return false;
     }
+    if (out.handover) {
+        const bool striped = std::any_of(out.stripes.begin(), out.stripes.end(), [](int k) { return k > 1; });
+        if (out.readRatio >= 0.0 || striped || !out.rates.empty()) {
+            std::cerr << "--handover cannot be combined with --read-ratio, --stripes > 1 or --rate" << "\n";
+            return false;
+        }
+    }
+    if (out.ops > 0) {
+        // 固定轮数只用于普通独占循环
+        const bool striped = std::any_of(out.stripes.begin(), out.stripes.end(), [](int k) { return k > 1; });
+        if (out.readRatio >= 0.0 || striped || !out.rates.empty() || out.handover) {
+            std::cerr << "--ops cannot be combined with --read-ratio, --stripes > 1, --rate or --handover" << "\n";
+            return false;
+        }
+    }
+    if (out.sampleMs > 0.0 && out.sampleFile.empty()) {
+        std::cerr << "--sample-ms needs --sample-file" << "\n";
+        return false;
+    }
+    if (out.processes) {
+        // 跨进程模式走虚调用 runner；移交时间戳与线程组任务都在进程私有内存中
+        if (out.dispatch != "virtual" || out.readRatio >= 0.0 || out.handover || !out.groups.empty()) {
+            std::cerr << "--processes needs --dispatch virtual and cannot be combined with --read-ratio, --handover or --group"
+                      << "\n";
+            return false;
+        }
+        for (const auto& lk : out.locks) {
+            if (!is_process_shared_lock(lk)) {
+                std::cerr << "--processes needs process-shared locks (" << join_names(process_shared_lock_names())
+                          << "), got: " << lk << "\n";
+                return false;
+            }
+        }
+    }
+    if (out.profile) {
+        // 计数分片在进程私有内存中，子进程的计数无法汇总
+        if (out.processes) {
+            std::cerr << "--profile cannot be combined with --processes" << "\n";
+            return false;
+        }
+        // 每个锁之后紧跟其 prof: 版本，开销按相邻的同一运行点计算
+        std::vector<std::string> locks;
+        for (const auto& lk : out.locks) {
+            locks.push_back(lk);
+            if (lk.rfind("prof:", 0) == 0) continue;
+            if (is_known_lock("prof:" + lk)) {
+                locks.push_back("prof:" + lk);
+            } else {
+                std::cerr << "--profile: no prof: variant of " << lk << ", running it bare only" << "\n";
+            }
+        }
+        out.locks = locks;
+    }
     return true;
 }
 
@@ -164,47 +633,37 @@ static std::vector<int> parse_bins(const std::string& spec) {
     return out;
 }
 
-static std::unique_ptr<iLock> make_lock(const std::string& name) {
-    if (name == "mutex") {
-        return std::make_unique<StdMutexLock>();
-    }
-    if (name == "tas" || name == "spin" || name == "tas_spin") {
-        return std::make_unique<TasSpinlock>();
-    }
-    if (name == "tas_preload" || name == "spin_preload") {
-        return std::make_unique<TasSpinlockPreLoad>();
-    }
-    if (name == "ticket") {
-        return std::make_unique<TicketLock>();
-    }
-    if (name == "ticket_backoff" || name == "ticket_bo") {
-        return std::make_unique<TicketBackOff>();
-    }
-    if (name == "ticket_bopf" || name == "ticket_backoff_prefetch") {
-        return std::make_unique<TicketBackOffAndPreFetch>();
-    }
-    if (name == "mcs") {
-        return std::make_unique<McsLock>();
-    }
-    if (name == "mcs_preload") {
-        return std::make_unique<McsLockPreLoad>();
-    }
-    return nullptr;
+// CSV 字段内不能出现 ','，替换为 ';'（如 list:0,2,4-7）
+static std::string csv_safe(std::string s) {
+    std::replace(s.begin(), s.end(), ',', ';');
+    return s;
 }
 
-static std::unique_ptr<iRunTask> make_task(const std::string& task, int cpuParallelIters, int cpuLockedIters) {
-    if (task == "cpu_burn") {
-        int p = (cpuParallelIters > 0) ? cpuParallelIters : 2048;
-        int l = (cpuLockedIters > 0) ? cpuLockedIters : 32;
-        return std::make_unique<CpuBurnTask>(p, l);
+// compare base.json new.json [--threshold r]
+static int compare_main(int argc, char** argv) {
+    CompareOptions options;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--threshold" && i + 1 < argc) {
+            options.threshold = std::atof(argv[++i]);
+        } else if (a == "-h" || a == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            files.push_back(a);
+        }
     }
-    if (task == "do_nothing") {
-        return std::make_unique<DoNothingTask>();
+    if (files.size() != 2 || options.threshold < 0.0) {
+        std::cerr << "Usage: " << argv[0] << " compare base.json new.json [--threshold r]" << "\n";
+        return 2;
     }
-    return nullptr; // 如需扩展新任务，在此注册
+    const int regressions = compare_results(files[0], files[1], options, std::cout, std::cerr);
+    return regressions < 0 ? 2 : (regressions > 0 ? 1 : 0);
 }
 
 int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "compare") return compare_main(argc, argv);
     Args args;
     if (!parse_args(argc, argv, args)) {
         return 1;
@@ -212,10 +671,53 @@ int main(int argc, char** argv) {
 
     // 构造线程数列表（仅 -B）
     std::vector<int> threadCounts = parse_bins(args.threadBins);
+    // 线程组：线程数固定为各组之和，worker 按组顺序编号
+    std::vector<TaskGroup> taskGroups;
+    std::vector<int> groupOf;
+    for (const auto& g : args.groups) {
+        taskGroups.push_back(g.group);
+        groupOf.insert(groupOf.end(), static_cast<size_t>(g.group.threads), static_cast<int>(taskGroups.size()) - 1);
+    }
+    if (!args.groups.empty()) threadCounts = {static_cast<int>(groupOf.size())};
     if (threadCounts.empty()) {
         std::cerr << "Invalid -B bins spec results in empty thread set" << "\n";
         return 4;
     }
+    // worker i 使用线程槽位 i，槽位空间顶部保留给其他线程
+    if (*std::max_element(threadCounts.begin(), threadCounts.end()) > kMaxWorkerThreadSlots) {
+        std::cerr << "At most " << kMaxWorkerThreadSlots << " worker threads are supported" << "\n";
+        return 4;
+    }
+    // 拓扑发现 + 绑核策略（参数已在 parse_args 中校验）
+    Topology topo = Topology::discover();
+    Placement placement;
+    {
+        std::string err;
+        parse_placement(args.placement, placement, err);
+    }
+    // 等待内核在任何 worker 启动前设定；本机不支持时回退到默认内核
+    set_wait_config(args.wait);
+    if (wait_config().kernel != args.wait.kernel) {
+        std::cerr << "Wait kernel " << wait_kernel_name(args.wait.kernel) << " not supported on this CPU, using "
+                  << wait_kernel_name(wait_config().kernel) << "\n";
+    }
+    LockConfig lockCfg;
+    // 节点号可能不连续，按最大节点号 + 1 分配 cohort
+    for (const auto& c : topo.cpus()) lockCfg.numaNodes = std::max(lockCfg.numaNodes, c.node + 1);
+    lockCfg.cohortBatch = args.cohortBatch;
+    lockCfg.spinBudget = args.spinBudget;
+    lockCfg.backoff = args.backoff;
+    lockCfg.layout = args.layout;
+    lockCfg.elision = args.elision;
+    TaskConfig taskCfg;
+    taskCfg.parallelIters = args.cpuParallelIters;
+    taskCfg.lockedIters = args.cpuLockedIters;
+    taskCfg.sharedLines = args.sharedLines;
+    taskCfg.privateBytes = static_cast<std::size_t>(args.privateBytes);
+    taskCfg.memBytes = args.memBytes;
+    taskCfg.memLines = args.memLines;
+    taskCfg.hugePages = args.hugePages;
+    const Dispatch dispatch = (args.dispatch == "static") ? Dispatch::Static : Dispatch::Virtual;
     // 锁列表（仅 -L）
     std::vector<std::string> lockKinds = args.locks;
 
@@ -227,65 +729,627 @@ int main(int argc, char** argv) {
         return 5;
     }
     std::ostream* csvOut = &csvFileOut;
-    (*csvOut) << "task,lock,threads,duration,repeats,cpu_parallel_iters,cpu_locked_iters,avg_ops,ops_s" << '\n';
+    (*csvOut) << "task,lock,dispatch,workers,wait_kernel,threads,duration,ops_per_thread,warmup,repeats,repeats_used,cpu_parallel_iters,cpu_locked_iters,shared_lines,private_bytes,"
+               << "mem_bytes,mem_lines,huge_pages,"
+               << "stripes,keys,lock_bytes,stripes_bytes,lock_layout,rss_bytes_per_lock,avg_ops,ops_s,"
+               << "ops_s_stddev,ops_s_ci_low,ops_s_ci_high,elapsed_ns,ns_per_op,tsc_per_op,read_ratio,read_ops_s,write_ops_s,arrivals,offered_ops_s,"
+               << "cycles_per_op,instructions_per_op,llc_misses_per_op,perf_raw_per_op,ctx_switches_per_op,"
+               << "placement,cpu_map,"
+               << "thr_min_ops,thr_max_ops,thr_cv,jain_index,starved_threads,per_thread_ops,"
+               << "vol_csw,invol_csw,"
+               << "lat_p50_ns,lat_p90_ns,lat_p99_ns,lat_p999_ns,lat_max_ns,"
+               << "resp_p50_ns,resp_p90_ns,resp_p99_ns,resp_p999_ns,resp_max_ns,"
+               << "handover_p50_ns,handover_p90_ns,handover_p99_ns,handover_p999_ns,handover_max_ns,handover_frac,tsc_skew_ns,"
+               << "tx_commit_frac,tx_fallback_frac,tx_abort_conflict,tx_abort_capacity,tx_abort_busy,tx_abort_other,"
+               << "groups,group_ops_s,group_lat_p50_ns,group_lat_p99_ns,group_resp_p50_ns,group_resp_p99_ns,"
+               << "prof_contended_frac,prof_wait_ns,prof_hold_ns,prof_overhead" << '\n';
+
+    // 时间序列：每个采样区间一行每线程 + 一行 thread=all 合计
+    std::ofstream sampleOut;
+    if (args.sampleMs > 0.0) {
+        sampleOut.open(args.sampleFile, std::ios::out | std::ios::trunc);
+        if (!sampleOut) {
+            std::cerr << "Failed to open sample file: " << args.sampleFile << "\n";
+            return 5;
+        }
+        sampleOut << "task,lock,dispatch,threads,stripes,keys,offered_ops_s,repeat,t_ms,thread,ops_s" << '\n';
+        sampleOut << std::fixed;
+    }
 
     if (!args.csvOnly) {
         std::cout.setf(std::ios::fixed); std::cout.precision(2);
-        std::cout << "Task: " << args.runTask
-                  << ", Duration: " << args.duration << " s"
-                  << ", Repeats: " << args.repeats << "\n";
+        std::cout << "Task: " << args.runTask;
+        if (args.ops > 0) {
+            std::cout << ", Ops/thread: " << args.ops;
+        } else {
+            std::cout << ", Duration: " << args.duration << " s";
+        }
+        std::cout
+                  << ", Repeats: " << args.repeats
+                  << ", Dispatch: " << args.dispatch
+                  << ", Workers: " << (args.processes ? "processes" : "threads") << "\n";
+        std::cout << "Wait kernel: " << wait_kernel_summary() << "\n";
+        if (args.profile) std::cout << "Lock profile: " << profile_level_name(kLockProfileLevel) << " (LT_LOCK_PROFILE)" << "\n";
+        std::cout << "Topology: " << topo.summary() << ", Placement: " << placement.spec << "\n";
+    }
+
+    // 移交延迟：启动时校准 TSC，并在将要使用的 CPU 上检查跨核偏差
+    TscSkew tscSkew;
+    if (args.handover) {
+        const TscCalibration& tsc = tsc_calibration();
+        int maxThreads = *std::max_element(threadCounts.begin(), threadCounts.end());
+        std::vector<int> cpus;
+        for (int c : build_cpu_map(topo, placement, maxThreads)) {
+            if (std::find(cpus.begin(), cpus.end(), c) == cpus.end()) cpus.push_back(c);
+        }
+        tscSkew = measure_tsc_skew(cpus);
+        if (!tsc.invariant) {
+            std::cerr << "TSC is not invariant on this CPU; handover times may be off under frequency changes" << "\n";
+        }
+        if (!args.csvOnly) {
+            std::cout << "TSC: " << tsc_summary(tsc) << ", cross-core skew <= " << tscSkew.maxSkewNs << " ns";
+            if (tscSkew.worstCpu >= 0) std::cout << " (cpu " << tscSkew.worstCpu << ", min round trip " << tscSkew.minRoundTripNs << " ns)";
+            std::cout << "\n";
+        }
+    }
+
+    // elide:<lock>：没有 RTM 时每次都走真实锁
+    auto is_elided = [](const std::string& lk) { return lk.rfind("elide:", 0) == 0; };
+    if (!rtm_supported() && std::any_of(lockKinds.begin(), lockKinds.end(), is_elided)) {
+        std::cerr << "RTM (TSX) is not available on this CPU; elide: locks always take the fallback lock" << "\n";
     }
 
     auto avg = [](const std::vector<std::uint64_t>& v) {
         long double s = 0; for (auto x : v) s += x; return v.empty() ? 0.0 : static_cast<double>(s / v.size());
     };
 
+    // 常驻绑核线程池：跨重复/线程数/锁复用，空闲线程在 futex 上休眠
+    WorkerPool pool;
+    bool perfWarned = false;
+    // 运行点：条带数 × 键分布 × 到达率。K=1 只跑一次（无键分布），K>1 与每个 --keys 分布组合；
+    // 开环模式下每个组合再按 --rate 列表扫描（rate = 0 表示闭环）
+    struct RunPoint {
+        int stripes;
+        KeySpec keys;
+        double rate;
+    };
+    const bool openLoop = !args.rates.empty();
+    const std::vector<double> rates = openLoop ? args.rates : std::vector<double>{0.0};
+    std::vector<RunPoint> runPoints;
+    for (int k : args.stripes) {
+        for (double rate : rates) {
+            if (k <= 1) {
+                runPoints.push_back({1, KeySpec{}, rate});
+            } else {
+                for (const auto& ks : args.keys) runPoints.push_back({k, ks, rate});
+            }
+        }
+    }
+    const bool striped = std::any_of(args.stripes.begin(), args.stripes.end(), [](int k) { return k > 1; });
+    const char* arrivalName = args.arrivals == ArrivalProcess::Fixed ? "fixed" : "poisson";
+    const char* layoutName = args.layout == LockLayout::Packed ? "packed" : "line";
+    // --json-file：运行点在内存中收集，全部结束后一次写出
+    std::vector<ResultPoint> jsonPoints;
+    // --profile：裸锁各运行点的吞吐，prof: 版本的运行点据此计算开销
+    std::map<std::string, double> bareQps;
     for (const auto& lk : lockKinds) {
+        const bool elided = is_elided(lk);
+        // 无锁基线没有 lock() 可计时，--latency 的列对其留空
+        const bool lockLatency = args.latency && !is_atomic_baseline(lk);
         if (!args.csvOnly) {
             std::cout << "\n";
             std::cout << "Lock: " << lk << "\n";
-            std::cout << std::left << std::setw(10) << "Threads"
-                      << std::right << std::setw(20) << "Avg Ops"
-                      << std::setw(20) << "Ops/s" << "\n";
-            std::cout << std::string(50, '-') << "\n";
+            std::cout << std::left << std::setw(10) << "Threads";
+            if (striped) std::cout << std::setw(10) << "Stripes" << std::setw(16) << "Keys";
+            if (openLoop) std::cout << std::setw(14) << "Offered/s";
+            if (striped) std::cout << std::right << std::setw(12) << "RSS/lock";
+            std::cout << std::right << std::setw(20) << "Avg Ops"
+                      << std::setw(20) << "Ops/s"
+                      << std::setw(10) << "Jain" << std::setw(10) << "CV";
+            if (args.ciTarget > 0.0) {
+                std::cout << std::setw(8) << "Reps" << std::setw(10) << "CI(+-%)";
+            }
+            if (args.ops > 0) {
+                std::cout << std::setw(12) << "ns/op" << std::setw(12) << "TSC/op";
+            }
+            if (args.perf.enabled) {
+                std::cout << std::setw(12) << "Cycles/op" << std::setw(12) << "IPC" << std::setw(12) << "LLC/op";
+            }
+            if (lockLatency) {
+                std::cout << std::setw(12) << "p50(ns)" << std::setw(12) << "p99(ns)"
+                          << std::setw(12) << "p99.9(ns)";
+            }
+            if (openLoop) {
+                std::cout << std::setw(14) << "resp p50" << std::setw(14) << "resp p99" << std::setw(14) << "resp p99.9";
+            }
+            if (args.handover) {
+                std::cout << std::setw(12) << "ho p50" << std::setw(12) << "ho p99" << std::setw(12) << "ho p99.9";
+            }
+            if (elided) std::cout << std::setw(10) << "Commit%" << std::setw(10) << "Conflict" << std::setw(10) << "Capacity";
+            std::cout << "\n";
+            std::cout << std::string((elided ? 30 : 0) + 70 + (striped ? 38 : 0) + (openLoop ? 56 : 0) + (args.handover ? 36 : 0) + (args.ops > 0 ? 24 : 0) + (args.ciTarget > 0.0 ? 18 : 0) + (lockLatency ? 36 : 0) + (args.perf.enabled ? 36 : 0), '-') << "\n";
         }
         for (int tc : threadCounts) {
-            auto lock = make_lock(lk);
-            if (!lock) {
+            lockCfg.maxThreads = tc;
+            taskCfg.maxThreads = tc;
+            if (!is_known_lock(lk)) {
                 std::cerr << "Unknown lock kind: " << lk << "\n";
                 return 2;
             }
-            auto task = make_task(args.runTask, args.cpuParallelIters, args.cpuLockedIters);
-            if (!task) {
-                std::cerr << "Failed to create task: " << args.runTask << "\n";
-                return 3;
-            }
 
-            LockTestSys sys(std::move(lock), std::move(task), tc, args.duration);
+            for (const auto& rp : runPoints) {
+                const int stripes = rp.stripes;
+                const KeySpec& keys = rp.keys;
+                std::string rateText; // 时间序列中的 offered_ops_s 列（闭环为空）
+                if (openLoop) {
+                    std::ostringstream os;
+                    os << std::fixed << std::setprecision(2) << rp.rate;
+                    rateText = os.str();
+                }
+                lockCfg.stripes = stripes;
+                taskCfg.stripes = stripes;
+                RunOptions opts;
+                opts.recordLatency = lockLatency;
+                opts.readRatio = args.readRatio;
+                opts.perf = args.perf;
+                opts.pool = args.pool ? &pool : nullptr;
+                opts.sampleIntervalMs = args.sampleMs;
+                opts.keys = keys;
+                opts.arrivalRate = rp.rate;
+                opts.arrivals = args.arrivals;
+                opts.recordHandover = args.handover;
+                opts.opsPerThread = args.ops;
+                opts.cpuMap = build_cpu_map(topo, placement, tc);
+                if (opts.cpuMap.empty()) {
+                    std::cerr << "Placement " << placement.spec << " selects no online CPU" << "\n";
+                    return 6;
+                }
+                // 带绑核策略的线程组覆盖自己那一段 CPU 表
+                if (!args.groups.empty()) {
+                    opts.threadGroups = groupOf;
+                    size_t first = 0;
+                    for (const auto& g : args.groups) {
+                        if (!g.placement.empty()) {
+                            Placement gp;
+                            std::string err;
+                            parse_placement(g.placement, gp, err);
+                            const std::vector<int> cpus = build_cpu_map(topo, gp, g.group.threads);
+                            if (cpus.empty()) {
+                                std::cerr << "Group placement " << g.placement << " selects no online CPU" << "\n";
+                                return 6;
+                            }
+                            std::copy(cpus.begin(), cpus.end(), opts.cpuMap.begin() + static_cast<long>(first));
+                        }
+                        first += static_cast<size_t>(g.group.threads);
+                    }
+                }
+                // 常驻内存差：构造前后（锁构造函数会写入每个实例，页已驻留）
+                const std::size_t rssBefore = resident_bytes();
+                auto sys = args.processes
+                               ? make_process_runner(lk, args.runTask, lockCfg, taskCfg, tc, args.duration, opts)
+                           : args.groups.empty()
+                               ? make_runner(lk, args.runTask, lockCfg, taskCfg, tc, args.duration, opts, dispatch)
+                               : make_runner(lk, make_group_task(taskGroups, taskCfg), lockCfg, tc, args.duration, opts);
+                if (!sys) {
+                    std::cerr << "Failed to create task: " << args.runTask << "\n";
+                    return 3;
+                }
+                const std::size_t rssAfter = resident_bytes();
+                const double rssPerLock = rssAfter > rssBefore ? static_cast<double>(rssAfter - rssBefore) / stripes : 0.0;
+
+                // 预热：同一锁/任务实例跑一次不计数的窗口（线程池、缓存、锁状态就绪）
+                if (args.warmup > 0.0) sys->warm_up(args.warmup);
 
-            std::vector<std::uint64_t> lock_ops;
-            lock_ops.reserve(args.repeats);
-            for (int i = 0; i < args.repeats; ++i) {
-                auto ops_lock = sys.run_test();
-                lock_ops.push_back(ops_lock);
-            }
+                std::vector<std::uint64_t> lock_ops;
+                lock_ops.reserve(args.repeats);
+                std::vector<double> qpsSamples; // 每次重复的 ops/s，用于标准差与置信区间
+                SampleStats qpsStats;
+                int used = 0;
+                LatencyHistogram latency; // merged over all repeats
+                LatencyHistogram response; // open loop: merged response time
+                LatencyHistogram handover; // --handover: merged handover latency
+                // 公平性：min 取各次最小、max 取各次最大、cv/jain 取均值、starved 取最坏一次
+                std::vector<double> perThreadSum(tc, 0.0);
+                std::uint64_t thrMin = UINT64_MAX, thrMax = 0;
+                double cvSum = 0.0, jainSum = 0.0;
+                int starvedWorst = 0;
+                double vcswSum = 0.0, ivcswSum = 0.0;
+                double readSum = 0.0;
+                // 线程组：各组总轮数与合并后的延迟
+                std::vector<double> groupOps(taskGroups.size(), 0.0);
+                std::vector<LatencyHistogram> groupLat(lockLatency ? taskGroups.size() : 0);
+                std::vector<LatencyHistogram> groupResp(openLoop ? taskGroups.size() : 0);
+                PerfValues perfSum; // 跨重复求和，除以总轮数得到每轮均值
+                std::uint64_t opsSum = 0;
+                const ElisionCounts tx0 = elision_counts(); // 预热之后的快照，差值即本运行点的计数
+                const LockProfileCounts prof0 = default_lock_profile().counts(); // prof: 锁同理
+                double elapsedSum = 0.0, ticksSum = 0.0; // --ops: 每次重复的首启动 → 末完成
+                // --json-file 的逐次重复样本（qpsSamples 之外）
+                std::vector<double> repLatP50, repLatP99, repRespP99, repHandoverP99, repNsPerOp;
+                for (int i = 0;; ++i) {
+                    RunResult r = sys->run_test();
+                    // shared_data 自己统计临界区次数，与写操作数不符说明锁没有互斥
+                    if (r.lockedCount >= 0 && static_cast<std::uint64_t>(r.lockedCount) != r.totalOps - r.readOps) {
+                        std::cerr << lk << ": shared_data counted " << r.lockedCount << " critical sections, expected "
+                                  << r.totalOps - r.readOps << " (mutual exclusion broken)" << "\n";
+                        return 5;
+                    }
+                    // 无锁基线：value() 的增量须等于总轮数，否则说明基线丢失或重复计数
+                    if (r.baselineCount >= 0 && static_cast<std::uint64_t>(r.baselineCount) != r.totalOps) {
+                        std::cerr << lk << ": value() advanced by " << r.baselineCount << ", expected " << r.totalOps
+                                  << " (baseline lost or double-counted updates)" << "\n";
+                        return 5;
+                    }
+                    lock_ops.push_back(r.totalOps);
+                    latency.merge(r.lockLatency);
+                    response.merge(r.responseLatency);
+                    handover.merge(r.handoverLatency);
+                    for (int t = 0; t < tc; ++t) perThreadSum[t] += static_cast<double>(r.perThreadOps[t]);
+                    thrMin = std::min(thrMin, r.fairness.minOps);
+                    thrMax = std::max(thrMax, r.fairness.maxOps);
+                    cvSum += r.fairness.cv;
+                    jainSum += r.fairness.jain;
+                    starvedWorst = std::max(starvedWorst, r.fairness.starved);
+                    readSum += static_cast<double>(r.readOps);
+                    for (int t = 0; t < static_cast<int>(groupOf.size()) && t < tc; ++t) {
+                        groupOps[groupOf[t]] += static_cast<double>(r.perThreadOps[t]);
+                    }
+                    for (size_t g = 0; g < r.groupLatency.size() && g < groupLat.size(); ++g) groupLat[g].merge(r.groupLatency[g]);
+                    for (size_t g = 0; g < r.groupResponse.size() && g < groupResp.size(); ++g) groupResp[g].merge(r.groupResponse[g]);
+                    vcswSum += static_cast<double>(r.voluntaryCsw);
+                    ivcswSum += static_cast<double>(r.involuntaryCsw);
+                    perfSum.accumulate(r.perf, i == 0);
+                    opsSum += r.totalOps;
+                    elapsedSum += r.elapsedNs;
+                    ticksSum += static_cast<double>(r.elapsedTicks);
+                    // 固定轮数模式下窗口长度为实测跨度，否则为 -d
+                    const double runSeconds = args.ops > 0 ? r.elapsedNs / 1e9 : args.duration;
+                    qpsSamples.push_back(runSeconds > 0.0 ? static_cast<double>(r.totalOps) / runSeconds : 0.0);
+                    if (!args.jsonFile.empty()) {
+                        if (lockLatency) {
+                            repLatP50.push_back(static_cast<double>(r.lockLatency.percentile(0.50)));
+                            repLatP99.push_back(static_cast<double>(r.lockLatency.percentile(0.99)));
+                        }
+                        if (openLoop) repRespP99.push_back(static_cast<double>(r.responseLatency.percentile(0.99)));
+                        if (args.handover && r.handoverLatency.count() > 0) {
+                            repHandoverP99.push_back(static_cast<double>(r.handoverLatency.percentile(0.99)));
+                        }
+                        if (args.ops > 0 && r.totalOps > 0) repNsPerOp.push_back(r.elapsedNs * tc / static_cast<double>(r.totalOps));
+                    }
+                    // 区间吞吐 = 相邻快照差 / 区间长度（第一个区间从 t=0、计数 0 开始）
+                    double prevMs = 0.0;
+                    const std::vector<std::uint64_t>* prev = nullptr;
+                    for (const auto& smp : r.samples) {
+                        const double dt = (smp.tMs - prevMs) / 1000.0;
+                        std::uint64_t allOps = 0;
+                        for (int t = 0; t < tc; ++t) {
+                            const std::uint64_t d = smp.perThreadOps[t] - (prev ? (*prev)[t] : 0);
+                            allOps += d;
+                            sampleOut << args.runTask << ',' << lk << ',' << args.dispatch << ',' << tc << ',' << stripes << ','
+                                          << (stripes > 1 ? csv_safe(keys.spec) : std::string()) << ','
+                                          << rateText << ',' << i << ','
+                                      << std::setprecision(3) << smp.tMs << ',' << t << ','
+                                      << std::setprecision(2) << (dt > 0 ? d / dt : 0.0) << '\n';
+                        }
+                        sampleOut << args.runTask << ',' << lk << ',' << args.dispatch << ',' << tc << ',' << stripes << ','
+                                          << (stripes > 1 ? csv_safe(keys.spec) : std::string()) << ','
+                                          << rateText << ',' << i << ','
+                                  << std::setprecision(3) << smp.tMs << ",all,"
+                                  << std::setprecision(2) << (dt > 0 ? allOps / dt : 0.0) << '\n';
+                        prevMs = smp.tMs;
+                        prev = &smp.perThreadOps;
+                    }
+                    used = i + 1;
+                    // 固定模式跑满 -n 次；自适应模式在 -n 次之后直到置信区间够窄或达到上限
+                    if (used < args.repeats) continue;
+                    if (args.ciTarget <= 0.0 || used >= args.maxRepeats) break;
+                    if (summarize(qpsSamples).rel_half_width() <= args.ciTarget) break;
+                }
+                qpsStats = summarize(qpsSamples);
+                ElisionCounts tx = elision_counts();
+                tx.commits -= tx0.commits;
+                tx.fallbacks -= tx0.fallbacks;
+                for (int k = 0; k < kNumElisionAborts; ++k) tx.aborts[k] -= tx0.aborts[k];
+                auto txPerOp = [&](std::uint64_t v) {
+                    return opsSum ? static_cast<double>(v) / static_cast<double>(opsSum) : 0.0;
+                };
+                if (args.perf.enabled && perfSum.validMask == 0 && !perfWarned) {
+                    std::cerr << "perf_event_open unavailable (check /proc/sys/kernel/perf_event_paranoid); "
+                              << "perf columns left empty" << "\n";
+                    perfWarned = true;
+                }
+                auto perOp = [&](int e) {
+                    return opsSum ? static_cast<double>(perfSum.value[e]) / static_cast<double>(opsSum) : 0.0;
+                };
+                const double cvAvg = cvSum / used;
+                const double jainAvg = jainSum / used;
 
-            double avg_lock_ops = avg(lock_ops);
-            double lock_qps = avg_lock_ops / args.duration;
+                double avg_lock_ops = avg(lock_ops);
+                double lock_qps = args.ops > 0 ? qpsStats.mean : avg_lock_ops / args.duration;
+                // 每线程每轮的耗时：跨度 × 线程数 / 总轮数（= 跨度 / N）
+                const double nsPerOp = opsSum ? elapsedSum * tc / static_cast<double>(opsSum) : 0.0;
+                const double ticksPerOp = opsSum ? ticksSum * tc / static_cast<double>(opsSum) : 0.0;
+                // prof: 锁：本运行点的争用比例、每次获取的平均等待/持有时间，以及相对裸锁同一运行点的吞吐损失
+                const bool profiled = lk.rfind("prof:", 0) == 0;
+                LockProfileCounts prof = default_lock_profile().counts();
+                prof.acquisitions -= prof0.acquisitions;
+                prof.contended -= prof0.contended;
+                prof.waitTicks -= prof0.waitTicks;
+                prof.holdTicks -= prof0.holdTicks;
+                auto profPerAcq = [&](std::uint64_t v) {
+                    return prof.acquisitions ? static_cast<double>(v) / static_cast<double>(prof.acquisitions) : 0.0;
+                };
+                const std::string pointKey = std::to_string(tc) + '|' + std::to_string(stripes) + '|' + keys.spec + '|' + rateText;
+                if (!profiled) bareQps[lk + '|' + pointKey] = lock_qps;
+                const auto bareIt = profiled ? bareQps.find(lk.substr(5) + '|' + pointKey) : bareQps.end();
+                const bool haveOverhead = bareIt != bareQps.end() && bareIt->second > 0.0;
+                const double profOverhead = haveOverhead ? 1.0 - lock_qps / bareIt->second : 0.0;
+                const double nsPerTick = profiled && kLockProfileLevel == ProfileLevel::Timed ? tsc_calibration().nsPerTick : 0.0;
+
+                if (!args.csvOnly) {
+                    std::cout << std::left << std::setw(10) << tc;
+                    if (striped) std::cout << std::setw(10) << stripes << std::setw(16) << (stripes > 1 ? keys.spec : "-");
+                    if (openLoop) std::cout << std::setw(14) << std::setprecision(0) << rp.rate << std::setprecision(2);
+                    if (striped) std::cout << std::right << std::setw(12) << rssPerLock;
+                    std::cout << std::right << std::setw(20) << avg_lock_ops
+                              << std::setw(20) << lock_qps
+                              << std::setw(10) << std::setprecision(3) << jainAvg
+                              << std::setw(10) << cvAvg << std::setprecision(2);
+                    if (args.ciTarget > 0.0) {
+                        std::cout << std::setw(8) << used << std::setw(10) << qpsStats.rel_half_width() * 100.0;
+                    }
+                    if (args.ops > 0) {
+                        std::cout << std::setw(12) << nsPerOp << std::setw(12) << ticksPerOp;
+                    }
+                    if (args.perf.enabled) {
+                        auto cell = [&](bool ok, double v) {
+                            if (ok) std::cout << std::setw(12) << v; else std::cout << std::setw(12) << "-";
+                        };
+                        const bool ipcOk = perfSum.has(kPerfCycles) && perfSum.has(kPerfInstructions) &&
+                                           perfSum.value[kPerfCycles] > 0;
+                        cell(perfSum.has(kPerfCycles), perOp(kPerfCycles));
+                        cell(ipcOk, ipcOk ? static_cast<double>(perfSum.value[kPerfInstructions]) /
+                                                static_cast<double>(perfSum.value[kPerfCycles]) : 0.0);
+                        cell(perfSum.has(kPerfLlcMisses), perOp(kPerfLlcMisses));
+                    }
+                    if (lockLatency) {
+                        std::cout << std::setw(12) << latency.percentile(0.50)
+                                  << std::setw(12) << latency.percentile(0.99)
+                                  << std::setw(12) << latency.percentile(0.999);
+                    }
+                    if (openLoop) {
+                        std::cout << std::setw(14) << response.percentile(0.50)
+                                  << std::setw(14) << response.percentile(0.99)
+                                  << std::setw(14) << response.percentile(0.999);
+                    }
+                    if (args.handover) {
+                        std::cout << std::setw(12) << handover.percentile(0.50)
+                                  << std::setw(12) << handover.percentile(0.99)
+                                  << std::setw(12) << handover.percentile(0.999);
+                    }
+                    if (elided) {
+                        std::cout << std::setw(10) << txPerOp(tx.commits) * 100.0
+                                  << std::setw(10) << std::setprecision(3) << txPerOp(tx.aborts[kAbortConflict])
+                                  << std::setw(10) << txPerOp(tx.aborts[kAbortCapacity]) << std::setprecision(2);
+                    }
+                    if (starvedWorst > 0) {
+                        std::cout << "  [starved: " << starvedWorst << "]";
+                    }
+                    if (profiled) {
+                        std::cout << "  [contended " << profPerAcq(prof.contended) * 100.0 << "%";
+                        if (kLockProfileLevel == ProfileLevel::Timed) {
+                            std::cout << ", wait " << profPerAcq(prof.waitTicks) * nsPerTick << " ns, hold "
+                                      << profPerAcq(prof.holdTicks) * nsPerTick << " ns";
+                        }
+                        if (haveOverhead) std::cout << ", overhead " << profOverhead * 100.0 << "%";
+                        std::cout << "]";
+                    }
+                    std::cout << "\n";
+                    // 每组一行：吞吐（按总吞吐中该组所占轮数折算）与延迟
+                    for (size_t g = 0; g < args.groups.size(); ++g) {
+                        std::cout << "  group " << g << " [" << args.groups[g].spec << "]: "
+                                  << (opsSum ? lock_qps * groupOps[g] / static_cast<double>(opsSum) : 0.0) << " ops/s";
+                        if (lockLatency) {
+                            std::cout << ", lock p50/p99/p99.9 " << groupLat[g].percentile(0.50) << '/'
+                                      << groupLat[g].percentile(0.99) << '/' << groupLat[g].percentile(0.999) << " ns";
+                        }
+                        if (openLoop) {
+                            std::cout << ", resp p50/p99/p99.9 " << groupResp[g].percentile(0.50) << '/'
+                                      << groupResp[g].percentile(0.99) << '/' << groupResp[g].percentile(0.999) << " ns";
+                        }
+                        std::cout << "\n";
+                    }
+                }
+                int p = (args.runTask == "cpu_burn") ? ((args.cpuParallelIters > 0) ? args.cpuParallelIters : 2048) : 0;
+                const bool memTask = args.runTask == "mem_stream" || args.runTask == "mem_chase";
+                int l = (args.runTask == "cpu_burn" || memTask) ? ((args.cpuLockedIters > 0) ? args.cpuLockedIters : 32) : 0;
+                int sl = (args.runTask == "shared_data") ? args.sharedLines : 0;
+                long pb = (args.runTask == "shared_data") ? args.privateBytes : 0;
+                (*csvOut) << args.runTask << ',' << lk << ',' << args.dispatch << ','
+                          << (args.processes ? "processes" : "threads") << ',' << wait_kernel_name(wait_config().kernel) << ','
+                          << tc << ',';
+                // -d 与 --ops 二选一，未使用的一列留空
+                if (args.ops > 0) {
+                    (*csvOut) << ',' << args.ops << ',';
+                } else {
+                    (*csvOut) << args.duration << ",,";
+                }
+                (*csvOut) << args.warmup << ',' << args.repeats << ',' << used << ','
+                          << p << ',' << l << ','
+                          << sl << ',' << pb << ',';
+                // 访存任务参数；其他任务留空
+                if (memTask) {
+                    (*csvOut) << args.memBytes << ',' << args.memLines << ',' << (args.hugePages ? 1 : 0) << ',';
+                } else {
+                    (*csvOut) << ",,,";
+                }
+                (*csvOut)
+                          << stripes << ',' << (stripes > 1 ? csv_safe(keys.spec) : std::string()) << ','
+                          << lock_size(lk) << ',' << lock_stride(lk, args.layout) * static_cast<std::size_t>(stripes) << ','
+                          << layoutName << ',' << std::fixed << std::setprecision(2) << rssPerLock << ','
+                          << std::fixed << std::setprecision(2) << avg_lock_ops << ','
+                          << std::fixed << std::setprecision(2) << lock_qps << ','
+                          << qpsStats.stddev << ',' << qpsStats.ciLow << ',' << qpsStats.ciHigh << ',';
+                // 固定轮数模式：平均跨度、每轮纳秒与 TSC 周期（参考周期，核心周期见 cycles_per_op）
+                if (args.ops > 0) {
+                    (*csvOut) << elapsedSum / used << ',' << std::setprecision(3) << nsPerOp << ',' << ticksPerOp << ','
+                              << std::setprecision(2);
+                } else {
+                    (*csvOut) << ",,,";
+                }
+                // 读写锁模式下分别给出读/写吞吐；独占模式留空
+                if (args.readRatio >= 0.0) {
+                    const double readQps = readSum / used / args.duration;
+                    (*csvOut) << args.readRatio << ',' << readQps << ',' << (lock_qps - readQps) << ',';
+                } else {
+                    (*csvOut) << ",,,";
+                }
+                // 开环模式：到达过程与目标总到达率（ops_s 为实际完成吞吐）；闭环留空
+                if (openLoop) {
+                    (*csvOut) << arrivalName << ',' << rp.rate << ',';
+                } else {
+                    (*csvOut) << ",,";
+                }
+                // 每轮平均计数；未开启 --perf 或该事件不可用时留空
+                for (int e = 0; e < kNumPerfEvents; ++e) {
+                    if (perfSum.has(e)) (*csvOut) << std::setprecision(3) << perOp(e);
+                    (*csvOut) << ',';
+                }
+                (*csvOut) << std::setprecision(2);
+                (*csvOut)
+                          << csv_safe(placement.spec) << ',';
+                // 实际绑核表：线程 i 对应的 CPU，以 ';' 分隔
+                for (int t = 0; t < tc; ++t) {
+                    (*csvOut) << (t ? ";" : "") << opts.cpuMap[t];
+                }
+                (*csvOut) << ','
+                          << thrMin << ',' << thrMax << ','
+                          << std::setprecision(4) << cvAvg << ',' << jainAvg << ','
+                          << starvedWorst << ',' << std::setprecision(0);
+                // 每线程平均 ops（跨重复），以 ';' 分隔，下标即线程编号
+                for (int t = 0; t < tc; ++t) {
+                    (*csvOut) << (t ? ";" : "") << perThreadSum[t] / used;
+                }
+                // 每次运行的平均上下文切换数（所有线程之和），用于观察自旋何时不再划算
+                (*csvOut) << std::setprecision(2) << ',' << vcswSum / used << ',' << ivcswSum / used;
+                // 未开启 --latency 时分位数列留空，保持表头稳定
+                if (lockLatency) {
+                    (*csvOut) << ',' << latency.percentile(0.50) << ',' << latency.percentile(0.90)
+                              << ',' << latency.percentile(0.99) << ',' << latency.percentile(0.999)
+                              << ',' << latency.max();
+                } else {
+                    (*csvOut) << ",,,,,";
+                }
+                // 开环响应时间：从计划到达时刻到临界区完成（含排队），闭环留空
+                if (openLoop) {
+                    (*csvOut) << ',' << response.percentile(0.50) << ',' << response.percentile(0.90)
+                              << ',' << response.percentile(0.99) << ',' << response.percentile(0.999)
+                              << ',' << response.max();
+                } else {
+                    (*csvOut) << ",,,,,";
+                }
+                // 移交延迟：仅统计真正的移交（前一持有者为其他线程，且在本线程等待期间释放）；
+                // handover_frac = 移交次数 / 总轮数。委托引擎与无锁基线没有移交，留空
+                if (args.handover && handover.count() > 0) {
+                    (*csvOut) << ',' << handover.percentile(0.50) << ',' << handover.percentile(0.90)
+                              << ',' << handover.percentile(0.99) << ',' << handover.percentile(0.999)
+                              << ',' << handover.max() << ',' << std::setprecision(4)
+                              << (opsSum ? static_cast<double>(handover.count()) / static_cast<double>(opsSum) : 0.0)
+                              << ',' << std::setprecision(1) << tscSkew.maxSkewNs << std::setprecision(2);
+                } else {
+                    (*csvOut) << ",,,,,,,";
+                }
+                // 锁消除：提交与回退占获取次数的比例，各类中止为每轮平均次数；非 elide: 锁留空
+                if (elided) {
+                    (*csvOut) << std::setprecision(4) << ',' << txPerOp(tx.commits) << ',' << txPerOp(tx.fallbacks);
+                    for (int k = 0; k < kNumElisionAborts; ++k) (*csvOut) << ',' << txPerOp(tx.aborts[k]);
+                    (*csvOut) << std::setprecision(2);
+                } else {
+                    (*csvOut) << ",,,,,,";
+                }
+                // 线程组：组参数以 '|' 分隔，各组数值以 ';' 分隔（顺序同 --group）；未开启对应模式的列留空
+                if (!args.groups.empty()) {
+                    auto list = [&](auto value) {
+                        (*csvOut) << ',';
+                        for (size_t g = 0; g < args.groups.size(); ++g) (*csvOut) << (g ? ";" : "") << value(g);
+                    };
+                    (*csvOut) << ',';
+                    for (size_t g = 0; g < args.groups.size(); ++g) (*csvOut) << (g ? "|" : "") << csv_safe(args.groups[g].spec);
+                    list([&](size_t g) { return opsSum ? lock_qps * groupOps[g] / static_cast<double>(opsSum) : 0.0; });
+                    if (lockLatency) {
+                        list([&](size_t g) { return groupLat[g].percentile(0.50); });
+                        list([&](size_t g) { return groupLat[g].percentile(0.99); });
+                    } else {
+                        (*csvOut) << ",,";
+                    }
+                    if (openLoop) {
+                        list([&](size_t g) { return groupResp[g].percentile(0.50); });
+                        list([&](size_t g) { return groupResp[g].percentile(0.99); });
+                    } else {
+                        (*csvOut) << ",,";
+                    }
+                } else {
+                    (*csvOut) << ",,,,,,";
+                }
+                // prof: 锁的剖析结果；时间列仅在 LT_LOCK_PROFILE=2 时有值，开销需要同一运行点的裸锁；其他锁留空
+                if (profiled) {
+                    (*csvOut) << std::setprecision(4) << ',' << profPerAcq(prof.contended) << std::setprecision(2) << ',';
+                    if (nsPerTick > 0.0) (*csvOut) << profPerAcq(prof.waitTicks) * nsPerTick;
+                    (*csvOut) << ',';
+                    if (nsPerTick > 0.0) (*csvOut) << profPerAcq(prof.holdTicks) * nsPerTick;
+                    (*csvOut) << ',';
+                    if (haveOverhead) (*csvOut) << std::setprecision(4) << profOverhead << std::setprecision(2);
+                } else {
+                    (*csvOut) << ",,,,";
+                }
+                (*csvOut) << '\n';
 
-            if (!args.csvOnly) {
-                std::cout << std::left << std::setw(10) << tc
-                          << std::right << std::setw(20) << avg_lock_ops
-                          << std::setw(20) << lock_qps << "\n";
-            }
-            int p = (args.runTask == "cpu_burn") ? ((args.cpuParallelIters > 0) ? args.cpuParallelIters : 2048) : 0;
-            int l = (args.runTask == "cpu_burn") ? ((args.cpuLockedIters > 0) ? args.cpuLockedIters : 32) : 0;
-            (*csvOut) << args.runTask << ',' << lk << ',' << tc << ','
-                      << args.duration << ',' << args.repeats << ','
-                      << p << ',' << l << ','
-                      << std::fixed << std::setprecision(2) << avg_lock_ops << ','
-                      << std::fixed << std::setprecision(2) << lock_qps
-                      << '\n';
+                if (!args.jsonFile.empty()) {
+                    ResultPoint jp;
+                    auto num = [](double v) {
+                        std::ostringstream os;
+                        os << v;
+                        return os.str();
+                    };
+                    jp.key = {{"task", args.runTask},
+                              {"lock", lk},
+                              {"dispatch", args.dispatch},
+                              {"workers", args.processes ? "processes" : "threads"},
+                              {"threads", std::to_string(tc)},
+                              {"stripes", std::to_string(stripes)},
+                              {"keys", stripes > 1 ? keys.spec : std::string()},
+                              {"offered_ops_s", rateText},
+                              {"read_ratio", args.readRatio >= 0.0 ? num(args.readRatio) : std::string()},
+                              {"groups", args.groups.empty() ? std::string() : std::to_string(args.groups.size())}};
+                    std::string cpuMap;
+                    for (int t = 0; t < tc; ++t) cpuMap += (t ? ";" : "") + std::to_string(opts.cpuMap[t]);
+                    jp.info = {{"wait_kernel", wait_kernel_name(wait_config().kernel)},
+                               {"duration", args.ops > 0 ? std::string() : num(args.duration)},
+                               {"ops_per_thread", args.ops > 0 ? std::to_string(args.ops) : std::string()},
+                               {"warmup", num(args.warmup)},
+                               {"cpu_parallel_iters", std::to_string(p)},
+                               {"cpu_locked_iters", std::to_string(l)},
+                               {"shared_lines", std::to_string(sl)},
+                               {"lock_layout", layoutName},
+                               {"placement", placement.spec},
+                               {"cpu_map", cpuMap}};
+                    jp.series.emplace_back("ops_s", qpsSamples);
+                    if (!repNsPerOp.empty()) jp.series.emplace_back("op_ns", repNsPerOp);
+                    if (!repLatP50.empty()) jp.series.emplace_back("lat_p50_ns", repLatP50);
+                    if (!repLatP99.empty()) jp.series.emplace_back("lat_p99_ns", repLatP99);
+                    if (!repRespP99.empty()) jp.series.emplace_back("resp_p99_ns", repRespP99);
+                    if (!repHandoverP99.empty()) jp.series.emplace_back("handover_p99_ns", repHandoverP99);
+                    jsonPoints.push_back(std::move(jp));
+                }
+            }
+        }
+    }
+    if (!args.jsonFile.empty()) {
+        std::string command;
+        for (int i = 0; i < argc; ++i) command += (i ? " " : "") + std::string(argv[i]);
+        if (!write_results_json(args.jsonFile, capture_environment(topo), command, jsonPoints)) {
+            std::cerr << "Failed to write JSON file: " << args.jsonFile << "\n";
+            return 5;
         }
     }
     return 0;
@@ -0,0 +1,25 @@
+#include "memUsage.h"
+
+#include <cstdio>
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace lt {
+
+std::size_t resident_bytes() {
+#if defined(__linux__)
+    std::FILE* f = std::fopen("/proc/self/statm", "r");
+    if (f == nullptr) return 0;
+    unsigned long size = 0, resident = 0;
+    const int n = std::fscanf(f, "%lu %lu", &size, &resident);
+    std::fclose(f);
+    if (n != 2) return 0;
+    const long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? static_cast<std::size_t>(resident) * static_cast<std::size_t>(page) : 0;
+#else
+    return 0;
+#endif
+}
+
+} // namespace lt
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace lt {
+
+// Resident set size of this process in bytes (/proc/self/statm), 0 where unavailable.
+// Sampled around runner construction to charge the pages a lock arena really touches to
+// each lock, which sizeof() misses (per-thread node arrays, allocator rounding).
+std::size_t resident_bytes();
+
+} // namespace lt
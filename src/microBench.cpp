@@ -0,0 +1,403 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "Backoff.h"
+#include "CacheLine.h"
+#include "ThreadSlot.h"
+#include "registry.h"
+#include "topology.h"
+#include "tscTimer.h"
+
+using namespace lt;
+
+// 微基准：单线程无竞争开销、两核乒乓移交、核间缓存行传输延迟矩阵。
+// 锁通过 make_lock() 构造（iLock 虚调用），计时全部用校准后的 TSC，且只在单个线程上读表，
+// 不受跨核偏差影响。
+
+struct Args {
+    std::string mode = "all";           // --mode uncontended|pingpong|c2c|all
+    std::vector<std::string> locks;     // -L 锁列表（默认全部注册的锁）
+    int cpuA = -1, cpuB = -1;           // --pair a,b 乒乓使用的两个 CPU（默认前两个在线 CPU）
+    std::string c2cCpus;                // --cpus list 核间矩阵覆盖的 CPU（默认全部在线 CPU）
+    std::uint64_t iters = 1000000;      // --iters 无竞争模式 lock/unlock 对数
+    std::uint64_t rounds = 100000;      // --rounds 乒乓模式每线程移交轮数
+    std::uint64_t c2cRounds = 20000;    // --c2c-rounds 每个 CPU 对的往返次数
+    std::string csvFile;                // --csv-file 无竞争与乒乓结果 CSV
+    std::string matrixFile;             // --matrix-file 核间延迟矩阵 CSV（N×N）
+    bool csvOnly = false;               // --csv-only 不打印表格
+};
+
+static void print_usage(const char* prog) {
+    std::cout << "Usage:\n"
+              << "  " << prog << " [--mode all] [-L mutex,ticket,mcs] [--pair 0,1] [--cpus 0-7] \\\n"
+              << "    [--csv-file micro.csv] [--matrix-file c2c.csv]\n";
+    std::cout << "  --mode m      uncontended | pingpong | c2c | all (default all)\n";
+    std::cout << "  -L locks      locks for uncontended/pingpong (default: every registered lock except\n"
+              << "                the atomic_* baselines)\n";
+    std::cout << "  --pair a,b    CPUs of the ping-pong threads (default: first two online CPUs)\n";
+    std::cout << "  --cpus list   CPUs of the core-to-core matrix, e.g. 0-7,16 (default: all online)\n";
+    std::cout << "  --iters n     uncontended lock()/unlock() pairs per lock (default 1000000)\n";
+    std::cout << "  --rounds n    ping-pong handovers per thread (default 100000)\n";
+    std::cout << "  --c2c-rounds n  round trips per CPU pair (default 20000)\n";
+    std::cout << "  --csv-file f  CSV for uncontended and ping-pong rows\n";
+    std::cout << "  --matrix-file f  N x N one-way latency matrix (ns) as CSV\n";
+    std::cout << "  --csv-only    suppress formatted tables\n";
+}
+
+static bool parse_u64(const char* s, std::uint64_t& out) {
+    try {
+        out = std::stoull(s);
+    } catch (...) {
+        return false;
+    }
+    return out > 0;
+}
+
+static bool parse_args(int argc, char** argv, Args& out) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--mode" && i + 1 < argc) {
+            out.mode = argv[++i];
+        } else if (a == "-L" && i + 1 < argc) {
+            std::stringstream ss(argv[++i]);
+            std::string item;
+            while (std::getline(ss, item, ',')) {
+                if (!item.empty()) out.locks.push_back(item);
+            }
+        } else if (a == "--pair" && i + 1 < argc) {
+            std::vector<int> v = parse_cpu_list(argv[++i]);
+            if (v.size() != 2) {
+                std::cerr << "--pair needs two CPU ids, e.g. 0,1" << "\n";
+                return false;
+            }
+            out.cpuA = v[0];
+            out.cpuB = v[1];
+        } else if (a == "--cpus" && i + 1 < argc) {
+            out.c2cCpus = argv[++i];
+        } else if (a == "--iters" && i + 1 < argc) {
+            if (!parse_u64(argv[++i], out.iters)) {
+                std::cerr << "Invalid --iters: " << argv[i] << "\n";
+                return false;
+            }
+        } else if (a == "--rounds" && i + 1 < argc) {
+            if (!parse_u64(argv[++i], out.rounds)) {
+                std::cerr << "Invalid --rounds: " << argv[i] << "\n";
+                return false;
+            }
+        } else if (a == "--c2c-rounds" && i + 1 < argc) {
+            if (!parse_u64(argv[++i], out.c2cRounds)) {
+                std::cerr << "Invalid --c2c-rounds: " << argv[i] << "\n";
+                return false;
+            }
+        } else if (a == "--csv-file" && i + 1 < argc) {
+            out.csvFile = argv[++i];
+        } else if (a == "--matrix-file" && i + 1 < argc) {
+            out.matrixFile = argv[++i];
+        } else if (a == "--csv-only") {
+            out.csvOnly = true;
+        } else if (a == "-h" || a == "--help") {
+            print_usage(argv[0]);
+            return false;
+        } else {
+            std::cerr << "Unknown or incomplete option: " << a << "\n";
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    if (!(out.mode == "all" || out.mode == "uncontended" || out.mode == "pingpong" || out.mode == "c2c")) {
+        std::cerr << "Unsupported --mode: " << out.mode << ", supported: uncontended, pingpong, c2c, all" << "\n";
+        return false;
+    }
+    // 无锁基线的 lock()/unlock() 只是测试用的 TAS 标志，不代表 update() 的代价，默认列表跳过
+    if (out.locks.empty()) {
+        for (const auto& lk : lock_names()) {
+            if (!is_atomic_baseline(lk)) out.locks.push_back(lk);
+        }
+    }
+    for (const auto& lk : out.locks) {
+        if (!is_known_lock(lk)) {
+            std::cerr << "Unknown lock kind: " << lk << "\n";
+            return false;
+        }
+        if (is_atomic_baseline(lk)) {
+            std::cerr << lk << " is a lock-free baseline; lock_micro times lock()/unlock(), which it does not use" << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace {
+
+constexpr int kBlocks = 20; // every measurement is split into blocks; median/min over blocks
+
+void pin_this_thread(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<unsigned>(cpu), &set);
+    (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+// Spin until a == want; yields after a while so two threads sharing one CPU still progress.
+void await(const std::atomic<std::uint64_t>& a, std::uint64_t want) {
+    unsigned spins = 0;
+    while (a.load(std::memory_order_acquire) != want) {
+        if (++spins < (1u << 14)) cpu_relax_once(); else yield_cpu();
+    }
+}
+
+struct BlockStats {
+    double medianNs {0.0};
+    double minNs {0.0};
+    double medianTicks {0.0};
+};
+
+// perOpTicks: one entry per block, TSC ticks per operation
+BlockStats summarize_blocks(std::vector<double> perOpTicks) {
+    BlockStats s;
+    if (perOpTicks.empty()) return s;
+    std::sort(perOpTicks.begin(), perOpTicks.end());
+    const double nsPerTick = tsc_calibration().nsPerTick;
+    s.medianTicks = perOpTicks[perOpTicks.size() / 2];
+    s.medianNs = s.medianTicks * nsPerTick;
+    s.minNs = perOpTicks.front() * nsPerTick;
+    return s;
+}
+
+// Single thread on cpu: back-to-back lock()/unlock() pairs on an idle lock.
+BlockStats bench_uncontended(const std::string& name, const LockConfig& cfg, int cpu, std::uint64_t iters) {
+    std::vector<double> blocks;
+    std::thread t([&] {
+        pin_this_thread(cpu);
+        set_this_thread_slot(0);
+        std::unique_ptr<iLock> lock = make_lock(name, cfg);
+        const std::uint64_t perBlock = std::max<std::uint64_t>(iters / kBlocks, 1);
+        for (std::uint64_t i = 0; i < perBlock; ++i) { lock->lock(); lock->unlock(); } // warm caches and predictors
+        for (int b = 0; b < kBlocks; ++b) {
+            const std::uint64_t t0 = tsc_now();
+            for (std::uint64_t i = 0; i < perBlock; ++i) {
+                lock->lock();
+                lock->unlock();
+            }
+            const std::uint64_t t1 = tsc_now();
+            blocks.push_back(static_cast<double>(t1 - t0) / static_cast<double>(perBlock));
+        }
+    });
+    t.join();
+    return summarize_blocks(blocks);
+}
+
+// Two threads on cpuA / cpuB take turns: wait for the turn word, lock(), pass the turn,
+// unlock(). The next owner is therefore always already waiting, so every acquisition is a
+// handover between the two cores (lock line plus turn line). Reported per handover.
+BlockStats bench_pingpong(const std::string& name, const LockConfig& cfg, int cpuA, int cpuB, std::uint64_t rounds) {
+    std::unique_ptr<iLock> lock = make_lock(name, cfg);
+    alignas(64) std::atomic<std::uint64_t> turn{0}; // round r: thread (r & 1) owns the turn
+    alignas(kCacheLine) std::atomic<int> ready{0};
+    volatile std::uint64_t shared = 0;              // touched under the lock only
+    const std::uint64_t total = 2 * rounds;         // handovers across both threads
+    const std::uint64_t perBlock = std::max<std::uint64_t>(total / kBlocks, 2) & ~std::uint64_t(1);
+    std::vector<double> blocks;
+    auto body = [&](int me, int cpu) {
+        pin_this_thread(cpu);
+        set_this_thread_slot(me);
+        ready.fetch_add(1, std::memory_order_acq_rel);
+        while (ready.load(std::memory_order_acquire) < 2) cpu_relax_once();
+        std::uint64_t blockStart = tsc_now();
+        for (std::uint64_t r = static_cast<std::uint64_t>(me); r < total; r += 2) {
+            await(turn, r);
+            lock->lock();
+            shared = shared + 1;
+            turn.store(r + 1, std::memory_order_release);
+            lock->unlock();
+            // thread 0 alone reads the clock: block boundaries fall on its own rounds
+            if (me == 0 && ((r + 2) % perBlock) == 0) {
+                const std::uint64_t now = tsc_now();
+                blocks.push_back(static_cast<double>(now - blockStart) / static_cast<double>(perBlock));
+                blockStart = now;
+            }
+        }
+    };
+    std::thread a(body, 0, cpuA), b(body, 1, cpuB);
+    a.join();
+    b.join();
+    return summarize_blocks(blocks);
+}
+
+// Raw cache-line transfer: cpu i stores 2r+1 into one line, cpu j waits for it and stores
+// 2r+2, i waits for that. Half a round trip is the one-way latency i -> j.
+double bench_c2c(int cpuI, int cpuJ, std::uint64_t rounds) {
+    alignas(64) std::atomic<std::uint64_t> line{0};
+    const std::uint64_t perBlock = std::max<std::uint64_t>(rounds / kBlocks, 1);
+    std::vector<double> blocks;
+    std::thread responder([&] {
+        pin_this_thread(cpuJ);
+        for (std::uint64_t r = 0; r < perBlock * kBlocks; ++r) {
+            await(line, 2 * r + 1);
+            line.store(2 * r + 2, std::memory_order_release);
+        }
+    });
+    std::thread initiator([&] {
+        pin_this_thread(cpuI);
+        for (int b = 0; b < kBlocks; ++b) {
+            const std::uint64_t t0 = tsc_now();
+            for (std::uint64_t k = 0; k < perBlock; ++k) {
+                const std::uint64_t r = static_cast<std::uint64_t>(b) * perBlock + k;
+                line.store(2 * r + 1, std::memory_order_release);
+                await(line, 2 * r + 2);
+            }
+            const std::uint64_t t1 = tsc_now();
+            blocks.push_back(static_cast<double>(t1 - t0) / static_cast<double>(2 * perBlock));
+        }
+    });
+    initiator.join();
+    responder.join();
+    return summarize_blocks(blocks).medianNs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Args args;
+    if (!parse_args(argc, argv, args)) {
+        return 1;
+    }
+    Topology topo = Topology::discover();
+    const TscCalibration& tsc = tsc_calibration();
+    if (!tsc.invariant) {
+        std::cerr << "TSC is not invariant on this CPU; results may be off under frequency changes" << "\n";
+    }
+    LockConfig cfg;
+    for (const auto& c : topo.cpus()) cfg.numaNodes = std::max(cfg.numaNodes, c.node + 1);
+    cfg.maxThreads = 2;
+
+    // 乒乓 CPU 对：默认前两个在线 CPU；只有一个 CPU 时两线程共用（结果仅作冒烟测试）
+    if (args.cpuA < 0) {
+        args.cpuA = topo.num_cpus() > 0 ? topo.cpus()[0].cpu : 0;
+        args.cpuB = topo.num_cpus() > 1 ? topo.cpus()[1].cpu : args.cpuA;
+    }
+    const bool runUncontended = args.mode == "all" || args.mode == "uncontended";
+    const bool runPingPong = args.mode == "all" || args.mode == "pingpong";
+    const bool runC2c = args.mode == "all" || args.mode == "c2c";
+
+    std::ofstream csvOut;
+    if (!args.csvFile.empty()) {
+        csvOut.open(args.csvFile, std::ios::out | std::ios::trunc);
+        if (!csvOut) {
+            std::cerr << "Failed to open CSV file: " << args.csvFile << "\n";
+            return 5;
+        }
+        csvOut << "bench,lock,cpu_a,cpu_b,ops,ns_per_op,ns_min,tsc_per_op" << '\n';
+        csvOut << std::fixed << std::setprecision(2);
+    }
+    if (!args.csvOnly) {
+        std::cout.setf(std::ios::fixed);
+        std::cout.precision(2);
+        std::cout << "Topology: " << topo.summary() << ", TSC: " << tsc_summary(tsc) << "\n";
+        if (runPingPong && args.cpuA == args.cpuB) {
+            std::cout << "Note: ping-pong threads share cpu " << args.cpuA << " (single CPU); numbers are scheduler-bound\n";
+        }
+    }
+
+    if (runUncontended || runPingPong) {
+        if (!args.csvOnly) {
+            std::cout << "\n" << std::left << std::setw(22) << "Lock" << std::right;
+            if (runUncontended) std::cout << std::setw(16) << "uncont ns/op" << std::setw(12) << "min ns" << std::setw(12) << "TSC/op";
+            if (runPingPong) std::cout << std::setw(18) << "pingpong ns/hand" << std::setw(12) << "min ns";
+            std::cout << "\n" << std::string(22 + (runUncontended ? 40 : 0) + (runPingPong ? 30 : 0), '-') << "\n";
+        }
+        for (const auto& lk : args.locks) {
+            if (!args.csvOnly) std::cout << std::left << std::setw(22) << lk << std::right << std::flush;
+            if (runUncontended) {
+                const BlockStats u = bench_uncontended(lk, cfg, args.cpuA, args.iters);
+                if (!args.csvOnly) std::cout << std::setw(16) << u.medianNs << std::setw(12) << u.minNs << std::setw(12) << u.medianTicks;
+                if (csvOut.is_open()) {
+                    csvOut << "uncontended," << lk << ',' << args.cpuA << ",," << args.iters << ','
+                           << u.medianNs << ',' << u.minNs << ',' << u.medianTicks << '\n';
+                }
+            }
+            if (runPingPong) {
+                const BlockStats p = bench_pingpong(lk, cfg, args.cpuA, args.cpuB, args.rounds);
+                if (!args.csvOnly) std::cout << std::setw(18) << p.medianNs << std::setw(12) << p.minNs;
+                if (csvOut.is_open()) {
+                    csvOut << "pingpong," << lk << ',' << args.cpuA << ',' << args.cpuB << ',' << 2 * args.rounds << ','
+                           << p.medianNs << ',' << p.minNs << ',' << p.medianTicks << '\n';
+                }
+            }
+            if (!args.csvOnly) std::cout << "\n";
+        }
+    }
+
+    if (runC2c) {
+        std::vector<int> cpus;
+        if (args.c2cCpus.empty()) {
+            for (const auto& c : topo.cpus()) cpus.push_back(c.cpu);
+        } else {
+            cpus = parse_cpu_list(args.c2cCpus);
+        }
+        const std::size_t n = cpus.size();
+        // matrix[i][j]：从 cpus[i] 到 cpus[j] 的单向延迟（ns），对角线为空
+        std::vector<std::vector<double>> matrix(n, std::vector<double>(n, 0.0));
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                if (i != j) matrix[i][j] = bench_c2c(cpus[i], cpus[j], args.c2cRounds);
+            }
+        }
+        if (!args.csvOnly) {
+            std::cout << "\nCore-to-core one-way latency (ns), row = initiator, column = responder\n";
+            if (n < 2) {
+                std::cout << "(needs at least two CPUs)\n";
+            } else {
+                std::cout << std::setw(6) << "cpu";
+                for (int c : cpus) std::cout << std::setw(8) << c;
+                std::cout << "\n" << std::setprecision(0);
+                for (std::size_t i = 0; i < n; ++i) {
+                    std::cout << std::setw(6) << cpus[i];
+                    for (std::size_t j = 0; j < n; ++j) {
+                        if (i == j) std::cout << std::setw(8) << "-"; else std::cout << std::setw(8) << matrix[i][j];
+                    }
+                    std::cout << "\n";
+                }
+                std::cout << std::setprecision(2);
+            }
+        }
+        if (!args.matrixFile.empty()) {
+            std::ofstream m(args.matrixFile, std::ios::out | std::ios::trunc);
+            if (!m) {
+                std::cerr << "Failed to open matrix file: " << args.matrixFile << "\n";
+                return 5;
+            }
+            m << "cpu";
+            for (int c : cpus) m << ',' << c;
+            m << '\n' << std::fixed << std::setprecision(1);
+            for (std::size_t i = 0; i < n; ++i) {
+                m << cpus[i];
+                for (std::size_t j = 0; j < n; ++j) {
+                    m << ',';
+                    if (i != j) m << matrix[i][j];
+                }
+                m << '\n';
+            }
+        }
+    }
+    return 0;
+}
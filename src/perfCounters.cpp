@@ -0,0 +1,129 @@
+#include "perfCounters.h"
+
+#include <cerrno>
+#include <cstring>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace lt {
+
+const char* perf_event_name(int event) {
+    switch (event) {
+    case kPerfCycles: return "cycles";
+    case kPerfInstructions: return "instructions";
+    case kPerfLlcMisses: return "llc_misses";
+    case kPerfRaw: return "perf_raw";
+    case kPerfContextSwitches: return "ctx_switches";
+    default: return "unknown";
+    }
+}
+
+#if defined(__linux__)
+
+namespace {
+
+int perf_open(perf_event_attr& attr, int groupFd) {
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0 /* this thread */, -1 /* any cpu */, groupFd, 0));
+}
+
+// Fills attr for one event; false if the event is not requested.
+bool describe(int event, const PerfConfig& cfg, perf_event_attr& attr) {
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (event) {
+    case kPerfCycles: attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+    case kPerfInstructions: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+    case kPerfLlcMisses: attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+    case kPerfRaw:
+        if (!cfg.haveRaw) return false;
+        attr.type = PERF_TYPE_RAW;
+        attr.config = cfg.rawConfig;
+        break;
+    case kPerfContextSwitches:
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+        break;
+    default: return false;
+    }
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_hv = 1;
+    return true;
+}
+
+} // namespace
+
+PerfCounterGroup::~PerfCounterGroup() { close(); }
+
+bool PerfCounterGroup::open(const PerfConfig& cfg) {
+    close();
+    for (int e = 0; e < kNumPerfEvents; ++e) {
+        perf_event_attr attr;
+        if (!describe(e, cfg, attr)) continue;
+        // only the leader carries disabled; members follow it
+        attr.disabled = (leader_ < 0) ? 1 : 0;
+        int fd = perf_open(attr, leader_);
+        if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+            // perf_event_paranoid >= 2 without CAP_PERFMON: user-space counts only
+            attr.exclude_kernel = 1;
+            fd = perf_open(attr, leader_);
+        }
+        if (fd < 0) continue; // event not supported here (e.g. no PMU in a VM)
+        if (leader_ < 0) leader_ = fd;
+        fds_[e] = fd;
+        order_[members_++] = e;
+    }
+    return leader_ >= 0;
+}
+
+void PerfCounterGroup::enable() {
+    if (leader_ < 0) return;
+    ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounterGroup::disable() {
+    if (leader_ >= 0) ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfValues PerfCounterGroup::read() const {
+    PerfValues out;
+    if (leader_ < 0) return out;
+    // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, value[nr]
+    std::uint64_t buf[3 + kNumPerfEvents] = {};
+    if (::read(leader_, buf, sizeof(buf)) < static_cast<ssize_t>(3 * sizeof(std::uint64_t))) return out;
+    const std::uint64_t nr = buf[0], enabled = buf[1], running = buf[2];
+    const double scale = (running > 0 && running < enabled) ? static_cast<double>(enabled) / running : 1.0;
+    for (std::uint64_t i = 0; i < nr && i < static_cast<std::uint64_t>(members_); ++i) {
+        const int e = order_[i];
+        out.value[e] = static_cast<std::uint64_t>(static_cast<double>(buf[3 + i]) * scale);
+        out.validMask |= 1u << e;
+    }
+    return out;
+}
+
+void PerfCounterGroup::close() {
+    for (int& fd : fds_) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+    leader_ = -1;
+    members_ = 0;
+}
+
+#else
+
+PerfCounterGroup::~PerfCounterGroup() = default;
+bool PerfCounterGroup::open(const PerfConfig&) { return false; }
+void PerfCounterGroup::enable() {}
+void PerfCounterGroup::disable() {}
+PerfValues PerfCounterGroup::read() const { return {}; }
+void PerfCounterGroup::close() {}
+
+#endif
+
+} // namespace lt
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+namespace lt {
+
+// Hardware/software events counted per worker with perf_event_open (Linux only).
+enum PerfEvent : int {
+    kPerfCycles = 0,
+    kPerfInstructions,
+    kPerfLlcMisses,      // PERF_COUNT_HW_CACHE_MISSES (last-level cache misses on most PMUs)
+    kPerfRaw,            // user-supplied raw event, e.g. cache-to-cache / HITM (model specific)
+    kPerfContextSwitches,
+    kNumPerfEvents
+};
+
+// Short name used in CSV column names, e.g. "cycles".
+const char* perf_event_name(int event);
+
+// Which counters to open; disabled by default so the plain run makes no syscalls.
+struct PerfConfig {
+    bool enabled {false};
+    bool haveRaw {false};          // open kPerfRaw with rawConfig
+    std::uint64_t rawConfig {0};   // PERF_TYPE_RAW config (umask << 8 | event on x86)
+};
+
+// Counter totals; an event whose bit is clear in validMask could not be opened.
+struct PerfValues {
+    std::uint64_t value[kNumPerfEvents] {};
+    std::uint32_t validMask {0};
+
+    bool has(int event) const { return (validMask >> event) & 1u; }
+
+    // Sum of two samples; an event stays valid only if both sides counted it.
+    void accumulate(const PerfValues& o, bool first) {
+        for (int e = 0; e < kNumPerfEvents; ++e) value[e] += o.value[e];
+        validMask = first ? o.validMask : (validMask & o.validMask);
+    }
+};
+
+// One counter group bound to the calling thread. Counters are opened disabled so
+// setup costs nothing; enable()/disable() bracket the measured window. Values are
+// scaled by time_enabled / time_running when the kernel multiplexed the group.
+class PerfCounterGroup {
+public:
+    PerfCounterGroup() = default;
+    ~PerfCounterGroup();
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    // Opens whichever events the kernel allows; false if none could be opened.
+    bool open(const PerfConfig& cfg);
+    void enable();
+    void disable();
+    PerfValues read() const;
+
+private:
+    void close();
+
+    int leader_ {-1};
+    int fds_[kNumPerfEvents] {-1, -1, -1, -1, -1};
+    int order_[kNumPerfEvents] {}; // event of the i-th group member (group read order)
+    int members_ {0};
+};
+
+} // namespace lt
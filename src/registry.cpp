@@ -0,0 +1,527 @@
+#include "registry.h"
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+
+#include "locks/StdMutexLock.h"
+#include "locks/TasSpinlock.h"
+#include "locks/TicketLock.h"
+#include "locks/McsLock.h"
+#include "locks/CohortLock.h"
+#include "locks/SlotQueueLocks.h"
+#include "locks/QSpinLock.h"
+#include "locks/FutexLocks.h"
+#include "locks/RWLocks.h"
+#include "locks/DelegationLocks.h"
+#include "locks/AtomicBaselines.h"
+#include "locks/ElisionLock.h"
+#include "locks/ProfiledLock.h"
+#include "locks/ShmLocks.h"
+#include "shmRegion.h"
+#include "tasks/SharedDataTask.h"
+#include "tasks/MemoryTask.h"
+#include "tasks/GroupTask.h"
+
+namespace lt {
+
+namespace {
+
+template <class... Ts> struct TypeList {};
+template <class T> struct Tag { using type = T; };
+
+// Lock registration: canonical name first, accepted aliases in matches(), constructor arguments in
+// args() (a tuple, so instances can be built on the heap or in place inside a LockArena).
+template <class L> struct LockEntry;
+
+template <> struct LockEntry<StdMutexLock> {
+    static std::string name() { return "mutex"; }
+    static bool matches(const std::string& n) { return n == "mutex"; }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+// Back-off variants are named <lock>@<policy>, e.g. spin@exp or ticket@prop; the historical
+// names stay as aliases of their policy-equivalent instantiation.
+template <class B> struct LockEntry<BasicTasSpinlock<B>> {
+    static std::string name() { return std::is_same_v<B, NoBackoff> ? "spin" : std::string("spin@") + B::kName; }
+    static bool matches(const std::string& n) {
+        if (std::is_same_v<B, NoBackoff> && (n == "tas" || n == "spin" || n == "tas_spin")) return true;
+        return n == std::string("spin@") + B::kName || n == std::string("tas@") + B::kName;
+    }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.backoff); }
+};
+template <class B> struct LockEntry<BasicTasSpinlockPreLoad<B>> {
+    static std::string name() {
+        return std::is_same_v<B, NoBackoff> ? "spin_preload" : std::string("spin_preload@") + B::kName;
+    }
+    static bool matches(const std::string& n) {
+        if (std::is_same_v<B, NoBackoff> && (n == "tas_preload" || n == "spin_preload")) return true;
+        return n == std::string("spin_preload@") + B::kName || n == std::string("tas_preload@") + B::kName;
+    }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.backoff); }
+};
+template <class B, bool PF> struct LockEntry<BasicTicketLock<B, PF>> {
+    static constexpr bool kProp = std::is_same_v<B, ProportionalBackoff>;
+    static std::string policy_name() { return std::string(PF ? "ticket_pf@" : "ticket@") + B::kName; }
+    static std::string name() {
+        if (!PF && std::is_same_v<B, NoBackoff>) return "ticket";
+        if (kProp) return PF ? "ticket_bopf" : "ticket_backoff";
+        return policy_name();
+    }
+    static bool matches(const std::string& n) {
+        if (n == name() || n == policy_name()) return true;
+        if (kProp && !PF) return n == "ticket_bo";
+        if (kProp && PF) return n == "ticket_backoff_prefetch";
+        return false;
+    }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.backoff); }
+};
+template <> struct LockEntry<McsLock> {
+    static std::string name() { return "mcs"; }
+    static bool matches(const std::string& n) { return n == "mcs"; }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+template <> struct LockEntry<McsLockPreLoad> {
+    static std::string name() { return "mcs_preload"; }
+    static bool matches(const std::string& n) { return n == "mcs_preload"; }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+template <> struct LockEntry<McsSlotLock> {
+    static std::string name() { return "mcs_slot"; }
+    static bool matches(const std::string& n) { return n == "mcs_slot"; }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.maxThreads); }
+};
+template <> struct LockEntry<ClhLock> {
+    static std::string name() { return "clh"; }
+    static bool matches(const std::string& n) { return n == "clh"; }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.maxThreads); }
+};
+template <> struct LockEntry<QSpinLock> {
+    static std::string name() { return "qspinlock"; }
+    static bool matches(const std::string& n) { return n == "qspinlock" || n == "qspin"; }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+template <> struct LockEntry<CohortLock> {
+    static std::string name() { return "cohort"; }
+    static bool matches(const std::string& n) { return n == "cohort" || n == "c_tkt_mcs"; }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.numaNodes, c.cohortBatch, c.maxThreads); }
+};
+// Process-shared (non-private futex) variants are named <lock>_shm.
+template <bool S> struct LockEntry<BasicFutexLock<S>> {
+    static std::string name() { return S ? "futex_shm" : "futex"; }
+    static bool matches(const std::string& n) { return n == name(); }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+template <bool S> struct LockEntry<BasicAdaptiveFutexLock<S>> {
+    static std::string name() { return S ? "futex_adaptive_shm" : "futex_adaptive"; }
+    static bool matches(const std::string& n) { return n == name() || (!S && n == "futex_spin"); }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.spinBudget); }
+};
+template <> struct LockEntry<McsParkLock> {
+    static std::string name() { return "mcs_park"; }
+    static bool matches(const std::string& n) { return n == "mcs_park"; }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.maxThreads, c.spinBudget); }
+};
+
+template <> struct LockEntry<ShmMcsLock> {
+    static std::string name() { return "mcs_shm"; }
+    static bool matches(const std::string& n) { return n == "mcs_shm"; }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+template <> struct LockEntry<PSharedMutexLock> {
+    static std::string name() { return "mutex_shm"; }
+    static bool matches(const std::string& n) { return n == "mutex_shm"; }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+
+// Reader-writer locks (also usable as plain exclusive locks)
+template <> struct LockEntry<SharedMutexRWLock> {
+    static std::string name() { return "rw_shared_mutex"; }
+    static bool matches(const std::string& n) { return n == "rw_shared_mutex" || n == "shared_mutex"; }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+template <> struct LockEntry<CentralRWSpinlock> {
+    static std::string name() { return "rw_spin"; }
+    static bool matches(const std::string& n) { return n == "rw_spin"; }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+template <> struct LockEntry<BigReaderRWLock> {
+    static std::string name() { return "rw_br"; }
+    static bool matches(const std::string& n) { return n == "rw_br" || n == "brlock"; }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.maxThreads); }
+};
+template <> struct LockEntry<PhaseFairRWLock> {
+    static std::string name() { return "rw_pft"; }
+    static bool matches(const std::string& n) { return n == "rw_pft" || n == "pft"; }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+
+// Delegation engines: the worker loop submits run_locked() through execute()
+template <> struct LockEntry<FlatCombiningLock> {
+    static std::string name() { return "fc"; }
+    static bool matches(const std::string& n) { return n == "fc" || n == "flat_combining"; }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.maxThreads); }
+};
+template <> struct LockEntry<ServerDelegationLock> {
+    static std::string name() { return "rcl"; }
+    static bool matches(const std::string& n) { return n == "rcl" || n == "delegate_server"; }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.maxThreads); }
+};
+
+// Lock-free baselines: the worker loop calls update() instead of lock/run_locked/unlock
+template <> struct LockEntry<FetchAddBaseline> {
+    static std::string name() { return "atomic_faa"; }
+    static bool matches(const std::string& n) { return n == "atomic_faa" || n == "fetch_add"; }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+template <> struct LockEntry<CasLoopBaseline> {
+    static std::string name() { return "atomic_cas"; }
+    static bool matches(const std::string& n) { return n == "atomic_cas" || n == "cas_loop"; }
+    static auto args(const LockConfig&) { return std::make_tuple(); }
+};
+template <> struct LockEntry<ShardedCounterBaseline> {
+    static std::string name() { return "atomic_sharded"; }
+    static bool matches(const std::string& n) { return n == "atomic_sharded" || n == "sharded"; }
+    static auto args(const LockConfig& c) { return std::make_tuple(c.maxThreads); }
+};
+
+// elide:<lock> wraps a registered lock (any of its names) in the RTM elision decorator.
+template <class L> struct LockEntry<ElidedLock<L>> {
+    static std::string name() { return "elide:" + LockEntry<L>::name(); }
+    static bool matches(const std::string& n) { return n.rfind("elide:", 0) == 0 && LockEntry<L>::matches(n.substr(6)); }
+    static auto args(const LockConfig& c) { return std::tuple_cat(std::make_tuple(c.elision), LockEntry<L>::args(c)); }
+};
+
+// prof:<lock> wraps a registered lock in the contention-profiling decorator; every instance
+// reports into default_lock_profile().
+template <class L> struct LockEntry<ProfiledLock<L>> {
+    static std::string name() { return "prof:" + LockEntry<L>::name(); }
+    static bool matches(const std::string& n) { return n.rfind("prof:", 0) == 0 && LockEntry<L>::matches(n.substr(5)); }
+    static auto args(const LockConfig& c) {
+        return std::tuple_cat(std::tuple<LockProfile&>(default_lock_profile()), LockEntry<L>::args(c));
+    }
+};
+
+// Task registration, same shape as LockEntry.
+template <class T> struct TaskEntry;
+
+template <> struct TaskEntry<CpuBurnTask> {
+    static std::string name() { return "cpu_burn"; }
+    static bool matches(const std::string& n) { return n == "cpu_burn"; }
+    static std::unique_ptr<CpuBurnTask> create(const TaskConfig& c) {
+        int p = (c.parallelIters > 0) ? c.parallelIters : 2048;
+        int l = (c.lockedIters > 0) ? c.lockedIters : 32;
+        return std::make_unique<CpuBurnTask>(p, l);
+    }
+};
+template <> struct TaskEntry<DoNothingTask> {
+    static std::string name() { return "do_nothing"; }
+    static bool matches(const std::string& n) { return n == "do_nothing"; }
+    static std::unique_ptr<DoNothingTask> create(const TaskConfig&) { return std::make_unique<DoNothingTask>(); }
+};
+template <> struct TaskEntry<SharedDataTask> {
+    static std::string name() { return "shared_data"; }
+    static bool matches(const std::string& n) { return n == "shared_data"; }
+    static std::unique_ptr<SharedDataTask> create(const TaskConfig& c) {
+        return std::make_unique<SharedDataTask>(c.sharedLines, c.privateBytes, c.maxThreads, c.stripes);
+    }
+};
+template <> struct TaskEntry<MemStreamTask> {
+    static std::string name() { return "mem_stream"; }
+    static bool matches(const std::string& n) { return n == "mem_stream"; }
+    static std::unique_ptr<MemStreamTask> create(const TaskConfig& c) {
+        return std::make_unique<MemStreamTask>(c.memBytes, c.memLines, c.lockedIters, c.hugePages, c.maxThreads);
+    }
+};
+template <> struct TaskEntry<MemChaseTask> {
+    static std::string name() { return "mem_chase"; }
+    static bool matches(const std::string& n) { return n == "mem_chase"; }
+    static std::unique_ptr<MemChaseTask> create(const TaskConfig& c) {
+        return std::make_unique<MemChaseTask>(c.memBytes, c.memLines, c.lockedIters, c.hugePages, c.maxThreads);
+    }
+};
+
+template <template <class> class L>
+using WithBackoffs = TypeList<L<NoBackoff>, L<ConstantBackoff>, L<ProportionalBackoff>, L<ExpBackoff>, L<RandExpBackoff>>;
+template <class B> using TicketNoPf = BasicTicketLock<B, false>;
+template <class B> using TicketPf = BasicTicketLock<B, true>;
+
+template <class... Ts> using Elided = TypeList<ElidedLock<Ts>...>;
+template <class... Ts> using Profiled = TypeList<ProfiledLock<Ts>...>;
+static_assert(detail::HasTryLock<QSpinLock>::value, "prof:qspinlock uses try_lock() as its fast path");
+
+template <class... Lists> struct Concat;
+template <class... Ts> struct Concat<TypeList<Ts...>> { using type = TypeList<Ts...>; };
+template <class... As, class... Bs, class... Rest>
+struct Concat<TypeList<As...>, TypeList<Bs...>, Rest...> {
+    using type = typename Concat<TypeList<As..., Bs...>, Rest...>::type;
+};
+
+// New locks / tasks: add a LockEntry / TaskEntry specialization and list the type here.
+using Locks = typename Concat<
+    TypeList<StdMutexLock>,
+    WithBackoffs<BasicTasSpinlock>, WithBackoffs<BasicTasSpinlockPreLoad>,
+    WithBackoffs<TicketNoPf>, WithBackoffs<TicketPf>,
+    TypeList<McsLock, McsLockPreLoad, McsSlotLock, ClhLock, QSpinLock, CohortLock,
+             FutexLock, AdaptiveFutexLock, McsParkLock,
+             SharedFutexLock, SharedAdaptiveFutexLock, ShmMcsLock, PSharedMutexLock,
+             SharedMutexRWLock, CentralRWSpinlock, BigReaderRWLock, PhaseFairRWLock,
+             FlatCombiningLock, ServerDelegationLock,
+             FetchAddBaseline, CasLoopBaseline, ShardedCounterBaseline>,
+    // elision over the exclusive locks in their default configuration (no back-off variants)
+    Elided<StdMutexLock, BasicTasSpinlock<NoBackoff>, BasicTasSpinlockPreLoad<NoBackoff>, TicketNoPf<NoBackoff>,
+           McsLock, McsLockPreLoad, McsSlotLock, ClhLock, QSpinLock, CohortLock,
+           FutexLock, AdaptiveFutexLock, McsParkLock>,
+    // profiling over the same set
+    Profiled<StdMutexLock, BasicTasSpinlock<NoBackoff>, BasicTasSpinlockPreLoad<NoBackoff>, TicketNoPf<NoBackoff>,
+             McsLock, McsLockPreLoad, McsSlotLock, ClhLock, QSpinLock, CohortLock,
+             FutexLock, AdaptiveFutexLock, McsParkLock>>::type;
+using Tasks = TypeList<CpuBurnTask, DoNothingTask, SharedDataTask, MemStreamTask, MemChaseTask>;
+
+// Calls f(Tag<T>{}) for the first registered type whose entry matches name; false if none does.
+template <template <class> class Entry, class F, class... Ts>
+bool find_type(TypeList<Ts...>, const std::string& name, F&& f) {
+    return ((Entry<Ts>::matches(name) ? (f(Tag<Ts>{}), true) : false) || ...);
+}
+
+// Locks usable from several processes when placed in a shared mapping: all state inline,
+// no addresses in the lock words, no process-local node pools, no private futexes.
+template <class L> struct ProcessShared : std::false_type {};
+template <class B> struct ProcessShared<BasicTasSpinlock<B>> : std::true_type {};
+template <class B> struct ProcessShared<BasicTasSpinlockPreLoad<B>> : std::true_type {};
+template <class B, bool PF> struct ProcessShared<BasicTicketLock<B, PF>> : std::true_type {};
+template <> struct ProcessShared<SharedFutexLock> : std::true_type {};
+template <> struct ProcessShared<SharedAdaptiveFutexLock> : std::true_type {};
+template <> struct ProcessShared<ShmMcsLock> : std::true_type {};
+template <> struct ProcessShared<PSharedMutexLock> : std::true_type {};
+
+template <class L>
+std::unique_ptr<L> create_lock(const LockConfig& cfg) {
+    return std::apply([](auto&&... a) { return std::make_unique<L>(a...); }, LockEntry<L>::args(cfg));
+}
+
+// cfg.stripes instances of L in one arena laid out per cfg.layout.
+template <class L, class I>
+LockArena<I> build_arena(const LockConfig& cfg) {
+    const auto args = LockEntry<L>::args(cfg);
+    return LockArena<I>::template build<L>(static_cast<std::size_t>(std::max(cfg.stripes, 1)), cfg.layout, [&](void* p) {
+        return std::apply([p](auto&&... a) { return new (p) L(a...); }, args);
+    });
+}
+
+// The same inside region (allocated there, kept mapped by the arena).
+template <class L, class I>
+LockArena<I> build_arena_in(const LockConfig& cfg, const std::shared_ptr<ShmRegion>& region) {
+    const auto args = LockEntry<L>::args(cfg);
+    const std::size_t count = static_cast<std::size_t>(std::max(cfg.stripes, 1));
+    void* storage = region->allocate(lock_stride_for(sizeof(L), alignof(L), cfg.layout) * count,
+                                     lock_align_for(alignof(L), cfg.layout));
+    return LockArena<I>::template build_in<L>(storage, region, count, cfg.layout, [&](void* p) {
+        return std::apply([p](auto&&... a) { return new (p) L(a...); }, args);
+    });
+}
+
+// Creates cfg.stripes instances of the named lock through interface I; empty if the name is
+// unknown or its type does not derive from I.
+template <class I>
+LockArena<I> make_locks_as(const std::string& name, const LockConfig& cfg) {
+    LockArena<I> out;
+    find_type<LockEntry>(Locks{}, name, [&](auto tag) {
+        using L = typename decltype(tag)::type;
+        if constexpr (std::is_base_of_v<I, L>) out = build_arena<L, I>(cfg);
+    });
+    return out;
+}
+
+template <template <class> class Entry, class... Ts>
+std::vector<std::string> names_of(TypeList<Ts...>) {
+    return { Entry<Ts>::name()... };
+}
+
+} // namespace
+
+std::unique_ptr<iLock> make_lock(const std::string& name, const LockConfig& cfg) {
+    std::unique_ptr<iLock> out;
+    find_type<LockEntry>(Locks{}, name, [&](auto tag) {
+        using L = typename decltype(tag)::type;
+        out = create_lock<L>(cfg);
+    });
+    return out;
+}
+
+std::unique_ptr<iRunTask> make_task(const std::string& name, const TaskConfig& cfg) {
+    std::unique_ptr<iRunTask> out;
+    find_type<TaskEntry>(Tasks{}, name, [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        out = TaskEntry<T>::create(cfg);
+    });
+    return out;
+}
+
+std::unique_ptr<iRunTask> make_group_task(const std::vector<TaskGroup>& groups, const TaskConfig& base) {
+    std::vector<std::unique_ptr<iRunTask>> tasks;
+    std::vector<int> groupOf;
+    for (const auto& g : groups) {
+        TaskConfig cfg = base;
+        cfg.parallelIters = g.parallelIters;
+        cfg.lockedIters = g.lockedIters;
+        auto task = make_task(g.task, cfg);
+        if (!task) return nullptr;
+        groupOf.insert(groupOf.end(), static_cast<std::size_t>(std::max(g.threads, 0)), static_cast<int>(tasks.size()));
+        tasks.push_back(std::move(task));
+    }
+    return std::make_unique<GroupTask>(std::move(tasks), std::move(groupOf));
+}
+
+bool is_known_lock(const std::string& name) {
+    return find_type<LockEntry>(Locks{}, name, [](auto) {});
+}
+
+bool is_rw_lock(const std::string& name) {
+    bool rw = false;
+    find_type<LockEntry>(Locks{}, name, [&](auto tag) {
+        rw = std::is_base_of_v<iRWLock, typename decltype(tag)::type>;
+    });
+    return rw;
+}
+
+bool is_delegation_lock(const std::string& name) {
+    bool delegation = false;
+    find_type<LockEntry>(Locks{}, name, [&](auto tag) {
+        delegation = std::is_base_of_v<iDelegationLock, typename decltype(tag)::type>;
+    });
+    return delegation;
+}
+
+bool is_atomic_baseline(const std::string& name) {
+    bool baseline = false;
+    find_type<LockEntry>(Locks{}, name, [&](auto tag) {
+        baseline = std::is_base_of_v<iAtomicBaseline, typename decltype(tag)::type>;
+    });
+    return baseline;
+}
+
+bool owns_server_thread(const std::string& name) {
+    bool server = false;
+    find_type<LockEntry>(Locks{}, name, [&](auto tag) {
+        server = std::is_base_of_v<ServerDelegationLock, typename decltype(tag)::type>;
+    });
+    return server;
+}
+
+bool is_process_shared_lock(const std::string& name) {
+    bool shared = false;
+    find_type<LockEntry>(Locks{}, name, [&](auto tag) { shared = ProcessShared<typename decltype(tag)::type>::value; });
+    return shared;
+}
+
+std::vector<std::string> process_shared_lock_names() {
+    std::vector<std::string> out;
+    for (const auto& n : lock_names()) {
+        if (is_process_shared_lock(n)) out.push_back(n);
+    }
+    return out;
+}
+
+std::size_t lock_size(const std::string& name) {
+    std::size_t size = 0;
+    find_type<LockEntry>(Locks{}, name, [&](auto tag) { size = sizeof(typename decltype(tag)::type); });
+    return size;
+}
+
+std::size_t lock_stride(const std::string& name, LockLayout layout) {
+    std::size_t stride = 0;
+    find_type<LockEntry>(Locks{}, name, [&](auto tag) {
+        using L = typename decltype(tag)::type;
+        stride = lock_stride_for(sizeof(L), alignof(L), layout);
+    });
+    return stride;
+}
+
+bool is_known_task(const std::string& name) {
+    return find_type<TaskEntry>(Tasks{}, name, [](auto) {});
+}
+
+std::vector<std::string> lock_names() { return names_of<LockEntry>(Locks{}); }
+std::vector<std::string> task_names() { return names_of<TaskEntry>(Tasks{}); }
+
+std::unique_ptr<iTestRunner> make_runner(const std::string& lockName, const std::string& taskName,
+                                         const LockConfig& lockCfg, const TaskConfig& taskCfg,
+                                         int numThreads, double durationSeconds, const RunOptions& options,
+                                         Dispatch dispatch) {
+    const bool rwMode = options.readRatio >= 0.0;
+    if (rwMode && (!is_rw_lock(lockName) || lockCfg.stripes > 1)) return nullptr;
+    if (dispatch == Dispatch::Virtual) {
+        auto task = make_task(taskName, taskCfg);
+        if (!task) return nullptr;
+        return make_runner(lockName, std::move(task), lockCfg, numThreads, durationSeconds, options);
+    }
+    std::unique_ptr<iTestRunner> out;
+    find_type<LockEntry>(Locks{}, lockName, [&](auto lockTag) {
+        using L = typename decltype(lockTag)::type;
+        find_type<TaskEntry>(Tasks{}, taskName, [&](auto taskTag) {
+            using T = typename decltype(taskTag)::type;
+            out = std::make_unique<BasicLockTestSys<L, T>>(build_arena<L, L>(lockCfg), TaskEntry<T>::create(taskCfg),
+                                                          numThreads, durationSeconds, options);
+        });
+    });
+    return out;
+}
+
+std::unique_ptr<iTestRunner> make_runner(const std::string& lockName, std::unique_ptr<iRunTask> task,
+                                         const LockConfig& lockCfg, int numThreads, double durationSeconds,
+                                         const RunOptions& options) {
+    const bool rwMode = options.readRatio >= 0.0;
+    if (!task || (rwMode && (!is_rw_lock(lockName) || lockCfg.stripes > 1))) return nullptr;
+    // the interface decides which worker loop the virtual runner uses
+    if (rwMode) {
+        return std::make_unique<RWLockTestSys>(make_locks_as<iRWLock>(lockName, lockCfg), std::move(task),
+                                               numThreads, durationSeconds, options);
+    }
+    auto delegation = make_locks_as<iDelegationLock>(lockName, lockCfg);
+    if (!delegation.empty()) {
+        return std::make_unique<DelegationLockTestSys>(std::move(delegation), std::move(task), numThreads,
+                                                       durationSeconds, options);
+    }
+    auto baseline = make_locks_as<iAtomicBaseline>(lockName, lockCfg);
+    if (!baseline.empty()) {
+        return std::make_unique<AtomicBaselineTestSys>(std::move(baseline), std::move(task), numThreads,
+                                                       durationSeconds, options);
+    }
+    auto locks = make_locks_as<iLock>(lockName, lockCfg);
+    if (locks.empty()) return nullptr;
+    return std::make_unique<LockTestSys>(std::move(locks), std::move(task), numThreads, durationSeconds, options);
+}
+
+std::unique_ptr<iTestRunner> make_process_runner(const std::string& lockName, const std::string& taskName,
+                                                 const LockConfig& lockCfg, const TaskConfig& taskCfg,
+                                                 int numThreads, double durationSeconds, RunOptions options) {
+    if (options.readRatio >= 0.0 || !is_known_task(taskName)) return nullptr;
+    std::unique_ptr<iTestRunner> out;
+    find_type<LockEntry>(Locks{}, lockName, [&](auto tag) {
+        using L = typename decltype(tag)::type;
+        if constexpr (ProcessShared<L>::value) {
+            const std::size_t lockBytes =
+                lock_stride_for(sizeof(L), alignof(L), lockCfg.layout) * static_cast<std::size_t>(std::max(lockCfg.stripes, 1));
+            const bool sharedData = TaskEntry<SharedDataTask>::matches(taskName);
+            const std::size_t dataBytes = sharedData ? SharedDataTask::shared_bytes(taskCfg.sharedLines, taskCfg.stripes) : 0;
+            auto region = ShmRegion::create(lockBytes + dataBytes + detail::process_harness_bytes(numThreads) + 4 * kCacheLine);
+            auto locks = build_arena_in<L, iLock>(lockCfg, region);
+            std::unique_ptr<iRunTask> task;
+            if (sharedData) {
+                // the protected lines move into the mapping as well (aliasing pointer owns the region)
+                std::shared_ptr<void> lines(region, region->allocate(dataBytes, kCacheLine));
+                task = std::make_unique<SharedDataTask>(taskCfg.sharedLines, taskCfg.privateBytes, taskCfg.maxThreads,
+                                                        taskCfg.stripes, std::move(lines));
+            } else {
+                task = make_task(taskName, taskCfg);
+            }
+            options.processes = region;
+            options.pool = nullptr;
+            out = std::make_unique<LockTestSys>(std::move(locks), std::move(task), numThreads, durationSeconds,
+                                                std::move(options));
+        }
+    });
+    return out;
+}
+
+} // namespace lt
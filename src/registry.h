@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "iLock.h"
+#include "iRunTask.h"
+#include "Backoff.h"
+#include "lockTestSys.h"
+#include "lockArena.h"
+#include "locks/ElisionLock.h"
+
+namespace lt {
+
+// Runtime parameters needed to construct a lock.
+struct LockConfig {
+    int numaNodes = 1;          // NUMA node count from topology discovery
+    unsigned cohortBatch = 64;  // cohort lock: max consecutive same-node handovers
+    int maxThreads = 1;         // thread count of the run (locks with per-slot node arrays)
+    unsigned spinBudget = 128;  // futex_adaptive / mcs_park: spin rounds before parking
+    BackoffParams backoff;      // <lock>@<policy> variants: base / max / yield threshold
+    int stripes = 1;            // striped mode: instances created per runner (each built from this config)
+    LockLayout layout = LockLayout::Line; // spacing of the instances in the runner's lock arena
+    ElisionPolicy elision;      // elide:<lock>: transactional attempts and hint handling
+};
+
+// Runtime parameters needed to construct a task.
+struct TaskConfig {
+    int parallelIters = 2048;   // cpu_burn: iterations outside the lock
+    int lockedIters = 32;       // cpu_burn: iterations inside the lock
+    int sharedLines = 4;        // shared_data: shared cache lines written per critical section
+    std::size_t privateBytes = 4096; // shared_data: private working set per thread
+    int maxThreads = 1;         // thread count of the run (tasks with per-slot state)
+    int stripes = 1;            // striped mode: one copy of shared state per lock stripe
+    std::size_t memBytes = 32768; // mem_stream / mem_chase: per-thread buffer size
+    int memLines = 64;          // mem_stream / mem_chase: cache lines touched per run_parallel()
+    bool hugePages = false;     // mem_stream / mem_chase: back the buffers with huge pages
+};
+
+// One thread group of a heterogeneous run: `threads` workers running their own task instance.
+struct TaskGroup {
+    int threads = 1;
+    std::string task = "cpu_burn";
+    int parallelIters = 2048;   // cpu_burn: iterations outside the lock
+    int lockedIters = 32;       // cpu_burn / mem_*: iterations inside the lock
+};
+
+// How the worker loop calls into the lock and task.
+enum class Dispatch {
+    Virtual, // through iLock / iRunTask (one loop for all pairs)
+    Static,  // concrete types, one inlined loop per (lock, task) pair
+};
+
+// Registries are type lists (see registry.cpp); names accepted by -L / -r resolve against them.
+std::unique_ptr<iLock> make_lock(const std::string& name, const LockConfig& cfg);
+std::unique_ptr<iRunTask> make_task(const std::string& name, const TaskConfig& cfg);
+// GroupTask over one task per group (base with the group's iteration counts); workers are
+// assigned to groups in order. nullptr if a task name is unknown.
+std::unique_ptr<iRunTask> make_group_task(const std::vector<TaskGroup>& groups, const TaskConfig& base);
+bool is_known_lock(const std::string& name);
+bool is_rw_lock(const std::string& name);   // implements iRWLock (usable with a read ratio)
+bool is_delegation_lock(const std::string& name); // implements iDelegationLock (sections run by a combiner/server)
+bool owns_server_thread(const std::string& name); // every instance starts its own spinning server thread
+bool is_atomic_baseline(const std::string& name); // implements iAtomicBaseline (update() replaces the critical section)
+bool is_process_shared_lock(const std::string& name); // works when placed in memory shared between processes
+std::vector<std::string> process_shared_lock_names();
+std::size_t lock_size(const std::string& name); // sizeof one instance (inline part, 0 if unknown)
+std::size_t lock_stride(const std::string& name, LockLayout layout); // arena bytes per instance (0 if unknown)
+bool is_known_task(const std::string& name);
+std::vector<std::string> lock_names(); // canonical names, registration order
+std::vector<std::string> task_names();
+
+// Runner for one (lock, task, threads) point; nullptr if the lock or task name is unknown,
+// or if options.readRatio selects the reader-writer loop and the lock is not an iRWLock (or is
+// striped). lockCfg.stripes > 1 builds a striped runner over that many lock instances.
+std::unique_ptr<iTestRunner> make_runner(const std::string& lockName, const std::string& taskName,
+                                         const LockConfig& lockCfg, const TaskConfig& taskCfg,
+                                         int numThreads, double durationSeconds, const RunOptions& options,
+                                         Dispatch dispatch);
+// Virtual-dispatch runner over an already built task (e.g. make_group_task()).
+std::unique_ptr<iTestRunner> make_runner(const std::string& lockName, std::unique_ptr<iRunTask> task,
+                                         const LockConfig& lockCfg, int numThreads, double durationSeconds,
+                                         const RunOptions& options);
+// Cross-process runner: the lock instances (and shared_data's shared lines) are placed in a
+// fresh shared mapping and every worker is a forked, pinned process; the loops, timing and
+// results are those of the virtual runner. nullptr unless is_process_shared_lock(lockName)
+// and the task is known; no reader-writer loop.
+std::unique_ptr<iTestRunner> make_process_runner(const std::string& lockName, const std::string& taskName,
+                                                 const LockConfig& lockCfg, const TaskConfig& taskCfg,
+                                                 int numThreads, double durationSeconds, RunOptions options);
+
+} // namespace lt
@@ -0,0 +1,541 @@
+#include "resultsJson.h"
+
+#include "sampleStats.h"
+#include "topology.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#if defined(__linux__)
+#include <sys/utsname.h>
+#endif
+
+// Set by CMake for this file; empty when built some other way.
+#ifndef LT_BUILD_TYPE
+#define LT_BUILD_TYPE ""
+#endif
+#ifndef LT_CXX_FLAGS
+#define LT_CXX_FLAGS ""
+#endif
+
+namespace lt {
+
+namespace {
+
+bool read_line(const std::string& path, std::string& out) {
+    std::ifstream f(path);
+    if (!f) return false;
+    return static_cast<bool>(std::getline(f, out));
+}
+
+std::string trim(const std::string& s) {
+    const size_t b = s.find_first_not_of(" \t");
+    const size_t e = s.find_last_not_of(" \t");
+    return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+}
+
+// First "<field> : value" of /proc/cpuinfo for each wanted field.
+std::map<std::string, std::string> cpuinfo_fields(const std::set<std::string>& wanted) {
+    std::map<std::string, std::string> res;
+    std::ifstream f("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(f, line) && res.size() < wanted.size()) {
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        const std::string name = trim(line.substr(0, colon));
+        if (wanted.count(name) != 0 && res.count(name) == 0) res[name] = trim(line.substr(colon + 1));
+    }
+    return res;
+}
+
+// Distinct values of a per-CPU cpufreq file, '/'-separated ("performance", "powersave/performance").
+std::string per_cpu_values(const Topology& topo, const std::string& file) {
+    std::set<std::string> values;
+    for (const auto& c : topo.cpus()) {
+        std::string v;
+        if (read_line("/sys/devices/system/cpu/cpu" + std::to_string(c.cpu) + "/cpufreq/" + file, v)) values.insert(trim(v));
+    }
+    std::string res;
+    for (const auto& v : values) res += (res.empty() ? "" : "/") + v;
+    return res;
+}
+
+std::string turbo_state() {
+    std::string v;
+    if (read_line("/sys/devices/system/cpu/intel_pstate/no_turbo", v)) return trim(v) == "0" ? "on" : "off";
+    if (read_line("/sys/devices/system/cpu/cpufreq/boost", v)) return trim(v) == "1" ? "on" : "off";
+    return "";
+}
+
+// "always [madvise] never" -> "madvise"
+std::string bracketed(const std::string& s) {
+    const size_t b = s.find('[');
+    const size_t e = s.find(']', b);
+    return b != std::string::npos && e != std::string::npos ? s.substr(b + 1, e - b - 1) : trim(s);
+}
+
+std::string utc_timestamp() {
+    const std::time_t now = std::time(nullptr);
+    std::tm tm {};
+#if defined(_WIN32)
+    gmtime_s(&tm, &now);
+#else
+    gmtime_r(&now, &tm);
+#endif
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return buf;
+}
+
+std::string compiler_id() {
+#if defined(__clang__)
+    return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    return std::string("gcc ") + __VERSION__;
+#else
+    return "unknown";
+#endif
+}
+
+// ---- JSON output ----
+
+void write_string(std::ostream& os, const std::string& s) {
+    os << '"';
+    for (unsigned char c : s) {
+        switch (c) {
+        case '"': os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '\n': os << "\\n"; break;
+        case '\t': os << "\\t"; break;
+        case '\r': os << "\\r"; break;
+        default:
+            if (c < 0x20) {
+                os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec
+                   << std::setfill(' ');
+            } else {
+                os << c;
+            }
+        }
+    }
+    os << '"';
+}
+
+void write_number(std::ostream& os, double v) {
+    if (std::isfinite(v)) os << v; else os << "null";
+}
+
+void write_object(std::ostream& os, const KeyValues& kv, const char* indent) {
+    os << "{";
+    for (size_t i = 0; i < kv.size(); ++i) {
+        os << (i ? ",\n" : "\n") << indent << "  ";
+        write_string(os, kv[i].first);
+        os << ": ";
+        write_string(os, kv[i].second);
+    }
+    os << "\n" << indent << "}";
+}
+
+// ---- JSON input: just enough for files written above ----
+
+struct JsonValue {
+    enum Type { Null, Bool, Number, String, Array, Object } type {Null};
+    double number {0.0};
+    std::string str;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* get(const std::string& k) const {
+        for (const auto& m : members) {
+            if (m.first == k) return &m.second;
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : s_(text) {}
+
+    JsonValue parse() {
+        JsonValue v = value();
+        skip_ws();
+        if (pos_ != s_.size()) fail("trailing characters");
+        return v;
+    }
+
+private:
+    [[noreturn]] void fail(const char* what) const {
+        throw std::runtime_error(std::string("JSON: ") + what + " at offset " + std::to_string(pos_));
+    }
+    void skip_ws() {
+        while (pos_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[pos_]))) ++pos_;
+    }
+    bool consume(char c) {
+        skip_ws();
+        if (pos_ < s_.size() && s_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+    void expect(char c) {
+        if (!consume(c)) fail("unexpected character");
+    }
+    bool literal(const char* word) {
+        const std::string w(word);
+        if (s_.compare(pos_, w.size(), w) != 0) return false;
+        pos_ += w.size();
+        return true;
+    }
+
+    JsonValue value() {
+        skip_ws();
+        if (pos_ >= s_.size()) fail("unexpected end");
+        JsonValue v;
+        const char c = s_[pos_];
+        if (c == '{') {
+            ++pos_;
+            v.type = JsonValue::Object;
+            if (consume('}')) return v;
+            do {
+                skip_ws();
+                std::string k = string();
+                expect(':');
+                v.members.emplace_back(std::move(k), value());
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            ++pos_;
+            v.type = JsonValue::Array;
+            if (consume(']')) return v;
+            do {
+                v.items.push_back(value());
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            v.type = JsonValue::String;
+            v.str = string();
+        } else if (literal("null")) {
+            v.type = JsonValue::Null;
+        } else if (literal("true")) {
+            v.type = JsonValue::Bool;
+            v.number = 1.0;
+        } else if (literal("false")) {
+            v.type = JsonValue::Bool;
+        } else {
+            const char* begin = s_.c_str() + pos_;
+            char* end = nullptr;
+            v.type = JsonValue::Number;
+            v.number = std::strtod(begin, &end);
+            if (end == begin) fail("invalid value");
+            pos_ += static_cast<size_t>(end - begin);
+        }
+        return v;
+    }
+
+    std::string string() {
+        if (pos_ >= s_.size() || s_[pos_] != '"') fail("expected string");
+        ++pos_;
+        std::string out;
+        while (pos_ < s_.size() && s_[pos_] != '"') {
+            char c = s_[pos_++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= s_.size()) break;
+            c = s_[pos_++];
+            switch (c) {
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'r': out += '\r'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+                // only the control characters write_string() escapes; others become '?'
+                const unsigned code = static_cast<unsigned>(std::strtoul(s_.substr(pos_, 4).c_str(), nullptr, 16));
+                out += code < 0x80 ? static_cast<char>(code) : '?';
+                pos_ += 4;
+                break;
+            }
+            default: out += c; // '"', '\\', '/'
+            }
+        }
+        if (pos_ >= s_.size()) fail("unterminated string");
+        ++pos_;
+        return out;
+    }
+
+    const std::string& s_;
+    size_t pos_ {0};
+};
+
+struct ResultsFile {
+    KeyValues environment;
+    std::vector<ResultPoint> points;
+};
+
+KeyValues read_key_values(const JsonValue* v) {
+    KeyValues kv;
+    if (v == nullptr || v->type != JsonValue::Object) return kv;
+    for (const auto& m : v->members) kv.emplace_back(m.first, m.second.type == JsonValue::String ? m.second.str : "");
+    return kv;
+}
+
+ResultsFile load_results(const std::string& path) {
+    std::ifstream f(path);
+    if (!f) throw std::runtime_error("cannot open " + path);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const std::string text = ss.str();
+    const JsonValue root = JsonParser(text).parse();
+    const JsonValue* format = root.get("format");
+    if (format == nullptr || format->str != "lock_test-results") throw std::runtime_error(path + " is not a lock_test results file");
+
+    ResultsFile res;
+    res.environment = read_key_values(root.get("environment"));
+    const JsonValue* points = root.get("points");
+    if (points == nullptr || points->type != JsonValue::Array) return res;
+    for (const auto& p : points->items) {
+        ResultPoint rp;
+        rp.key = read_key_values(p.get("key"));
+        rp.info = read_key_values(p.get("info"));
+        if (const JsonValue* series = p.get("series")) {
+            for (const auto& m : series->members) {
+                std::vector<double> xs;
+                for (const auto& x : m.second.items) {
+                    if (x.type == JsonValue::Number) xs.push_back(x.number);
+                }
+                rp.series.emplace_back(m.first, std::move(xs));
+            }
+        }
+        res.points.push_back(std::move(rp));
+    }
+    return res;
+}
+
+// "lock=mcs threads=8 stripes=16": the non-empty key fields
+std::string point_label(const KeyValues& key) {
+    std::string s;
+    for (const auto& kv : key) {
+        if (!kv.second.empty()) s += (s.empty() ? "" : " ") + kv.first + "=" + kv.second;
+    }
+    return s;
+}
+
+std::string point_id(const KeyValues& key) {
+    std::string s;
+    for (const auto& kv : key) s += kv.first + "=" + kv.second + "\x1f";
+    return s;
+}
+
+// Welch's t statistic and its Welch-Satterthwaite degrees of freedom.
+struct WelchTest {
+    double t {0.0};
+    double df {0.0};
+    bool valid {false}; // both sides have >= 2 samples
+};
+
+WelchTest welch(const SampleStats& a, const SampleStats& b) {
+    WelchTest w;
+    if (a.n < 2 || b.n < 2) return w;
+    const double va = a.stddev * a.stddev / static_cast<double>(a.n);
+    const double vb = b.stddev * b.stddev / static_cast<double>(b.n);
+    w.valid = true;
+    const double se = std::sqrt(va + vb);
+    if (se == 0.0) {
+        // identical repeats on both sides: any difference is exact
+        w.t = b.mean == a.mean ? 0.0 : std::copysign(INFINITY, b.mean - a.mean);
+        w.df = static_cast<double>(a.n + b.n - 2);
+        return w;
+    }
+    w.t = (b.mean - a.mean) / se;
+    w.df = (va + vb) * (va + vb) /
+           (va * va / static_cast<double>(a.n - 1) + vb * vb / static_cast<double>(b.n - 1));
+    return w;
+}
+
+} // namespace
+
+KeyValues capture_environment(const Topology& topo) {
+    KeyValues env;
+    const auto cpuinfo = cpuinfo_fields({"model name", "microcode", "CPU implementer", "CPU part", "CPU revision"});
+    auto field = [&](const char* k) {
+        auto it = cpuinfo.find(k);
+        return it == cpuinfo.end() ? std::string() : it->second;
+    };
+    std::string model = field("model name");
+    if (model.empty() && !field("CPU part").empty()) {
+        // Arm: no model name, identify by implementer/part/revision
+        model = "implementer " + field("CPU implementer") + " part " + field("CPU part") + " r" + field("CPU revision");
+    }
+    env.emplace_back("cpu_model", model);
+    env.emplace_back("microcode", field("microcode"));
+    env.emplace_back("topology", topo.summary());
+    std::string v;
+    env.emplace_back("smt", read_line("/sys/devices/system/cpu/smt/control", v) ? trim(v) : "");
+#if defined(__linux__)
+    struct utsname u {};
+    if (uname(&u) == 0) {
+        env.emplace_back("kernel", std::string(u.sysname) + " " + u.release + " " + u.version);
+        env.emplace_back("machine", u.machine);
+        env.emplace_back("hostname", u.nodename);
+    }
+#endif
+    env.emplace_back("cpufreq_driver", per_cpu_values(topo, "scaling_driver"));
+    env.emplace_back("governor", per_cpu_values(topo, "scaling_governor"));
+    env.emplace_back("max_freq_khz", per_cpu_values(topo, "scaling_max_freq"));
+    env.emplace_back("turbo", turbo_state());
+    env.emplace_back("thp", read_line("/sys/kernel/mm/transparent_hugepage/enabled", v) ? bracketed(v) : "");
+    env.emplace_back("numa_balancing", read_line("/proc/sys/kernel/numa_balancing", v) ? trim(v) : "");
+    env.emplace_back("compiler", compiler_id());
+    env.emplace_back("build_type", LT_BUILD_TYPE);
+    env.emplace_back("cxx_flags", trim(LT_CXX_FLAGS));
+    env.emplace_back("timestamp", utc_timestamp());
+    return env;
+}
+
+bool write_results_json(const std::string& path, const KeyValues& environment, const std::string& command,
+                        const std::vector<ResultPoint>& points) {
+    std::ofstream os(path, std::ios::out | std::ios::trunc);
+    if (!os) return false;
+    os << std::setprecision(12);
+    os << "{\n  \"format\": \"lock_test-results\",\n  \"version\": 1,\n  \"command\": ";
+    write_string(os, command);
+    os << ",\n  \"environment\": ";
+    write_object(os, environment, "  ");
+    os << ",\n  \"points\": [";
+    for (size_t i = 0; i < points.size(); ++i) {
+        const ResultPoint& p = points[i];
+        os << (i ? ",\n" : "\n") << "    {\n      \"key\": ";
+        write_object(os, p.key, "      ");
+        os << ",\n      \"info\": ";
+        write_object(os, p.info, "      ");
+        os << ",\n      \"series\": {";
+        for (size_t s = 0; s < p.series.size(); ++s) {
+            os << (s ? ",\n" : "\n") << "        ";
+            write_string(os, p.series[s].first);
+            os << ": [";
+            for (size_t k = 0; k < p.series[s].second.size(); ++k) {
+                if (k) os << ", ";
+                write_number(os, p.series[s].second[k]);
+            }
+            os << "]";
+        }
+        os << "\n      }\n    }";
+    }
+    os << "\n  ]\n}\n";
+    return static_cast<bool>(os);
+}
+
+int compare_results(const std::string& basePath, const std::string& newPath, const CompareOptions& options,
+                    std::ostream& out, std::ostream& err) {
+    ResultsFile base, next;
+    try {
+        base = load_results(basePath);
+        next = load_results(newPath);
+    } catch (const std::exception& e) {
+        err << e.what() << "\n";
+        return -1;
+    }
+
+    // the timestamp differs on every run
+    bool envHeader = false;
+    for (const auto& b : base.environment) {
+        if (b.first == "timestamp") continue;
+        std::string nv;
+        bool found = false;
+        for (const auto& n : next.environment) {
+            if (n.first == b.first) {
+                nv = n.second;
+                found = true;
+            }
+        }
+        if (found && nv == b.second) continue;
+        if (!envHeader) {
+            out << "Environment differs (base -> new); changes below may not come from the code:\n";
+            envHeader = true;
+        }
+        out << "  " << b.first << ": " << (b.second.empty() ? "-" : b.second) << " -> " << (nv.empty() ? "-" : nv) << "\n";
+    }
+    if (envHeader) out << "\n";
+
+    std::map<std::string, const ResultPoint*> baseById;
+    for (const auto& p : base.points) baseById[point_id(p.key)] = &p;
+
+    // one heading line per point with changes, then a row per changed series
+    out.setf(std::ios::fixed);
+    out << std::left << std::setw(20) << "  Metric" << std::right << std::setw(18) << "Base" << std::setw(18) << "New"
+        << std::setw(11) << "Change%" << std::setw(11) << "t" << "  " << "Verdict" << "\n";
+    out << std::string(20 + 18 + 18 + 11 + 11 + 14, '-') << "\n";
+    int matched = 0, regressions = 0, improvements = 0, unmatched = 0;
+    std::set<std::string> seen;
+    for (const auto& np : next.points) {
+        const std::string id = point_id(np.key);
+        auto it = baseById.find(id);
+        if (it == baseById.end()) {
+            ++unmatched;
+            continue;
+        }
+        seen.insert(id);
+        ++matched;
+        const ResultPoint& bp = *it->second;
+        bool headed = false;
+        auto heading = [&] {
+            if (headed) return;
+            headed = true;
+            out << point_label(np.key) << "\n";
+            // settings that are carried but not matched (e.g. -R, wait kernel, placement)
+            for (const auto& ni : np.info) {
+                for (const auto& bi : bp.info) {
+                    if (bi.first == ni.first && bi.second != ni.second) {
+                        out << "  (" << ni.first << ": " << (bi.second.empty() ? "-" : bi.second) << " -> "
+                            << (ni.second.empty() ? "-" : ni.second) << ")\n";
+                    }
+                }
+            }
+        };
+        for (const auto& ns : np.series) {
+            const std::vector<double>* bx = nullptr;
+            for (const auto& bs : bp.series) {
+                if (bs.first == ns.first) bx = &bs.second;
+            }
+            if (bx == nullptr || bx->empty() || ns.second.empty()) continue;
+            const SampleStats a = summarize(*bx);
+            const SampleStats b = summarize(ns.second);
+            const double rel = a.mean != 0.0 ? (b.mean - a.mean) / std::fabs(a.mean) : 0.0;
+            if (std::fabs(rel) < options.threshold) continue;
+            const WelchTest w = welch(a, b);
+            const bool significant =
+                w.valid && std::fabs(w.t) > student_t95(static_cast<std::size_t>(std::max(1.0, std::floor(w.df))));
+            const bool lowerIsBetter = ns.first.size() > 3 && ns.first.compare(ns.first.size() - 3, 3, "_ns") == 0;
+            const bool worse = lowerIsBetter ? rel > 0.0 : rel < 0.0;
+            const char* verdict = !w.valid ? "? (need >= 2 repeats)" : !significant ? "noise" : worse ? "REGRESSION" : "improved";
+            if (significant) (worse ? regressions : improvements)++;
+            heading();
+            out << "  " << std::left << std::setw(18) << ns.first << std::right << std::setprecision(2) << std::setw(18)
+                << a.mean << std::setw(18) << b.mean << std::setw(11) << rel * 100.0 << std::setw(11);
+            if (w.valid) out << w.t; else out << "-";
+            out << "  " << verdict << "\n";
+        }
+    }
+    for (const auto& bp : base.points) {
+        if (seen.count(point_id(bp.key)) == 0) ++unmatched;
+    }
+    out << "\n" << matched << " points compared (threshold " << std::setprecision(1) << options.threshold * 100.0
+        << "%), " << regressions << " significant regressions, " << improvements << " significant improvements";
+    if (unmatched > 0) out << ", " << unmatched << " points in only one file";
+    out << "\n";
+    return regressions;
+}
+
+} // namespace lt
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lt {
+
+class Topology;
+
+using KeyValues = std::vector<std::pair<std::string, std::string>>;
+
+// Machine state that changes results without any code change: CPU model and microcode,
+// topology, kernel, frequency governor / turbo / SMT / THP settings, compiler and flags.
+// Values that cannot be read (no sysfs, other OS) are left empty.
+KeyValues capture_environment(const Topology& topo);
+
+// One (lock, threads, ...) point of a sweep. key identifies the point across result files;
+// info is carried along but not matched (placement, duration, wait kernel, ...); series holds
+// one value per repeat ("ops_s", "lat_p99_ns", ...). Series named *_ns are lower-is-better.
+struct ResultPoint {
+    KeyValues key;
+    KeyValues info;
+    std::vector<std::pair<std::string, std::vector<double>>> series;
+};
+
+// {"format":"lock_test-results","version":1,"environment":{..},"command":"..","points":[..]};
+// returns false when the file cannot be written.
+bool write_results_json(const std::string& path, const KeyValues& environment, const std::string& command,
+                        const std::vector<ResultPoint>& points);
+
+struct CompareOptions {
+    double threshold {0.02}; // smallest relative change that is reported, significant or not
+};
+
+// Matches the points of two result files and tests every common series (Welch's t-test,
+// 95%). Prints environment differences and a row per changed series to out; returns the
+// number of significant regressions (throughput down or latency up), -1 if a file cannot
+// be read (message on err).
+int compare_results(const std::string& basePath, const std::string& newPath, const CompareOptions& options,
+                    std::ostream& out, std::ostream& err);
+
+} // namespace lt
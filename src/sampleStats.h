@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace lt {
+
+// Two-sided 95% Student t quantile for df degrees of freedom (normal beyond the table).
+inline double student_t95(std::size_t df) {
+    static const double kTable[] = {
+        0.0,    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201,  2.179,  2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080,  2.074,  2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+    constexpr std::size_t kMax = sizeof(kTable) / sizeof(kTable[0]) - 1;
+    if (df == 0) return 0.0;
+    if (df <= kMax) return kTable[df];
+    return df <= 60 ? 2.000 : (df <= 120 ? 1.980 : 1.960);
+}
+
+// Mean, sample standard deviation and 95% confidence interval of the mean of repeated runs.
+struct SampleStats {
+    std::size_t n {0};
+    double mean {0.0};
+    double stddev {0.0};  // sample (n - 1) standard deviation
+    double ciLow {0.0};
+    double ciHigh {0.0};
+
+    // CI half-width relative to the mean; 0 for fewer than two samples or a zero mean.
+    double rel_half_width() const { return mean != 0.0 ? (ciHigh - ciLow) / 2.0 / std::fabs(mean) : 0.0; }
+};
+
+inline SampleStats summarize(const std::vector<double>& xs) {
+    SampleStats s;
+    s.n = xs.size();
+    if (s.n == 0) return s;
+    long double sum = 0;
+    for (double x : xs) sum += x;
+    s.mean = static_cast<double>(sum / s.n);
+    if (s.n > 1) {
+        long double sq = 0;
+        for (double x : xs) sq += (x - s.mean) * (x - s.mean);
+        s.stddev = std::sqrt(static_cast<double>(sq / (s.n - 1)));
+    }
+    const double half = student_t95(s.n - 1) * s.stddev / std::sqrt(static_cast<double>(s.n));
+    s.ciLow = s.mean - half;
+    s.ciHigh = s.mean + half;
+    return s;
+}
+
+} // namespace lt
@@ -0,0 +1,51 @@
+#include "shmRegion.h"
+
+#include <atomic>
+#include <new>
+#include <string>
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace lt {
+
+std::shared_ptr<ShmRegion> ShmRegion::create(std::size_t bytes) {
+#if defined(__linux__)
+    static std::atomic<unsigned> seq{0};
+    const std::string name = "/lock_test." + std::to_string(static_cast<long>(getpid())) + "." +
+                             std::to_string(seq.fetch_add(1, std::memory_order_relaxed));
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) throw std::bad_alloc();
+    shm_unlink(name.c_str()); // the mapping keeps the object alive
+    const long page = sysconf(_SC_PAGESIZE);
+    const std::size_t p = page > 0 ? static_cast<std::size_t>(page) : 4096;
+    bytes = (bytes + p - 1) / p * p;
+    void* base = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+        base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) throw std::bad_alloc();
+    return std::shared_ptr<ShmRegion>(new ShmRegion(static_cast<char*>(base), bytes));
+#else
+    (void)bytes;
+    throw std::bad_alloc();
+#endif
+}
+
+ShmRegion::~ShmRegion() {
+#if defined(__linux__)
+    munmap(base_, size_);
+#endif
+}
+
+void* ShmRegion::allocate(std::size_t bytes, std::size_t align) {
+    const std::size_t start = (used_ + align - 1) & ~(align - 1);
+    if (start > size_ || size_ - start < bytes) throw std::bad_alloc();
+    used_ = start + bytes;
+    return base_ + start;
+}
+
+} // namespace lt
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CacheLine.h"
+#include <cstddef>
+#include <memory>
+
+namespace lt {
+
+// MAP_SHARED mapping of a POSIX shared memory object, handed out front to back. The object
+// is unlinked right after mapping, so nothing is left in /dev/shm once the last process
+// unmaps it; worker processes forked after create() see the region at the same address.
+// Pages are only backed when first touched, so a generous size costs nothing up front.
+class ShmRegion {
+public:
+    // throws std::bad_alloc if the object cannot be created or mapped
+    static std::shared_ptr<ShmRegion> create(std::size_t bytes);
+    ~ShmRegion();
+    ShmRegion(const ShmRegion&) = delete;
+    ShmRegion& operator=(const ShmRegion&) = delete;
+
+    // Next `bytes` at `align` (a power of two); throws std::bad_alloc when the region is full.
+    void* allocate(std::size_t bytes, std::size_t align = kCacheLine);
+
+    // Scratch use: release(mark()) drops everything allocated after the mark.
+    std::size_t mark() const { return used_; }
+    void release(std::size_t mark) { used_ = mark; }
+
+    std::size_t size() const { return size_; }
+
+private:
+    ShmRegion(char* base, std::size_t size) : base_(base), size_(size) {}
+
+    char* base_;
+    std::size_t size_;
+    std::size_t used_ {0};
+};
+
+} // namespace lt
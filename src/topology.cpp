@@ -0,0 +1,230 @@
+#include "topology.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+namespace lt {
+
+namespace {
+
+bool read_int(const std::string& path, int& out) {
+    std::ifstream f(path);
+    if (!f) return false;
+    int v = 0;
+    if (!(f >> v)) return false;
+    out = v;
+    return true;
+}
+
+bool read_line(const std::string& path, std::string& out) {
+    std::ifstream f(path);
+    if (!f) return false;
+    return static_cast<bool>(std::getline(f, out));
+}
+
+} // namespace
+
+std::vector<int> parse_cpu_list(const std::string& s) {
+    std::vector<int> res;
+    std::stringstream ss(s);
+    std::string tok;
+    while (std::getline(ss, tok, ',')) {
+        if (tok.empty()) continue;
+        size_t dash = tok.find('-');
+        try {
+            if (dash == std::string::npos) {
+                res.push_back(std::stoi(tok));
+            } else {
+                int a = std::stoi(tok.substr(0, dash));
+                int b = std::stoi(tok.substr(dash + 1));
+                for (int v = a; v <= b; ++v) res.push_back(v);
+            }
+        } catch (...) {
+            // skip malformed token
+        }
+    }
+    return res;
+}
+
+Topology Topology::discover() {
+    Topology t;
+#if defined(__linux__)
+    const std::string base = "/sys/devices/system/cpu/";
+    std::string online;
+    if (read_line(base + "online", online)) {
+        for (int cpu : parse_cpu_list(online)) {
+            CpuInfo c;
+            c.cpu = cpu;
+            const std::string topo = base + "cpu" + std::to_string(cpu) + "/topology/";
+            if (!read_int(topo + "core_id", c.core)) c.core = cpu;
+            if (!read_int(topo + "physical_package_id", c.package) || c.package < 0) c.package = 0;
+            t.cpus_.push_back(c);
+        }
+        // NUMA node membership comes from the node side of sysfs
+        std::string nodesOnline;
+        if (read_line("/sys/devices/system/node/online", nodesOnline)) {
+            for (int node : parse_cpu_list(nodesOnline)) {
+                std::string list;
+                if (!read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", list)) continue;
+                for (int cpu : parse_cpu_list(list)) {
+                    for (auto& c : t.cpus_) {
+                        if (c.cpu == cpu) c.node = node;
+                    }
+                }
+            }
+        }
+    }
+#endif
+    if (t.cpus_.empty()) {
+        unsigned hc = std::thread::hardware_concurrency();
+        for (unsigned i = 0; i < (hc > 0 ? hc : 1u); ++i) {
+            CpuInfo c;
+            c.cpu = static_cast<int>(i);
+            c.core = static_cast<int>(i);
+            t.cpus_.push_back(c);
+        }
+    }
+    std::sort(t.cpus_.begin(), t.cpus_.end(), [](const CpuInfo& a, const CpuInfo& b) { return a.cpu < b.cpu; });
+    // SMT rank: order of appearance among CPUs sharing (package, core)
+    std::map<std::pair<int, int>, int> seen;
+    for (auto& c : t.cpus_) {
+        c.smt = seen[{c.package, c.core}]++;
+    }
+    return t;
+}
+
+int Topology::num_cores() const {
+    std::set<std::pair<int, int>> s;
+    for (const auto& c : cpus_) s.insert({c.package, c.core});
+    return static_cast<int>(s.size());
+}
+
+int Topology::num_packages() const {
+    std::set<int> s;
+    for (const auto& c : cpus_) s.insert(c.package);
+    return static_cast<int>(s.size());
+}
+
+int Topology::num_nodes() const {
+    std::set<int> s;
+    for (const auto& c : cpus_) s.insert(c.node);
+    return static_cast<int>(s.size());
+}
+
+const CpuInfo* Topology::find(int cpu) const {
+    for (const auto& c : cpus_) {
+        if (c.cpu == cpu) return &c;
+    }
+    return nullptr;
+}
+
+std::string Topology::summary() const {
+    std::ostringstream os;
+    os << num_nodes() << " nodes, " << num_packages() << " packages, "
+       << num_cores() << " cores, " << num_cpus() << " cpus";
+    return os.str();
+}
+
+bool parse_placement(const std::string& spec, Placement& out, std::string& err) {
+    Placement p;
+    p.spec = spec;
+    const size_t colon = spec.find(':');
+    const std::string kind = spec.substr(0, colon);
+    const std::string rest = (colon == std::string::npos) ? std::string() : spec.substr(colon + 1);
+    if (kind == "rr") {
+        p.policy = PlacementPolicy::RoundRobin;
+    } else if (kind == "compact") {
+        p.policy = PlacementPolicy::Compact;
+    } else if (kind == "scatter") {
+        p.policy = PlacementPolicy::Scatter;
+    } else if (kind == "core") {
+        p.policy = PlacementPolicy::PhysicalCore;
+    } else if (kind == "node" || kind == "list") {
+        p.policy = (kind == "node") ? PlacementPolicy::Nodes : PlacementPolicy::List;
+        p.ids = parse_cpu_list(rest);
+        if (p.ids.empty()) {
+            err = "placement '" + kind + "' needs an id list, e.g. " + kind + ":0-3";
+            return false;
+        }
+    } else {
+        err = "unknown placement '" + spec + "', supported: rr, compact, scatter, core, node:<ids>, list:<cpus>";
+        return false;
+    }
+    if (colon != std::string::npos && p.ids.empty()) {
+        err = "placement '" + kind + "' takes no arguments";
+        return false;
+    }
+    out = p;
+    return true;
+}
+
+std::vector<int> build_cpu_map(const Topology& topo, const Placement& placement, int numThreads) {
+    std::vector<CpuInfo> order = topo.cpus();
+    auto compact_less = [](const CpuInfo& a, const CpuInfo& b) {
+        return std::tie(a.node, a.package, a.core, a.smt) < std::tie(b.node, b.package, b.core, b.smt);
+    };
+    switch (placement.policy) {
+    case PlacementPolicy::RoundRobin:
+        break; // already in CPU id order
+    case PlacementPolicy::Compact:
+        std::sort(order.begin(), order.end(), compact_less);
+        break;
+    case PlacementPolicy::PhysicalCore:
+        std::sort(order.begin(), order.end(), [](const CpuInfo& a, const CpuInfo& b) {
+            return std::tie(a.smt, a.node, a.package, a.core) < std::tie(b.smt, b.node, b.package, b.core);
+        });
+        break;
+    case PlacementPolicy::Scatter: {
+        // per package: first SMT thread of every core, then the second, ...; then interleave packages
+        std::map<int, std::vector<CpuInfo>> byPkg;
+        for (const auto& c : order) byPkg[c.package].push_back(c);
+        size_t longest = 0;
+        for (auto& kv : byPkg) {
+            std::sort(kv.second.begin(), kv.second.end(), [](const CpuInfo& a, const CpuInfo& b) {
+                return std::tie(a.smt, a.core) < std::tie(b.smt, b.core);
+            });
+            longest = std::max(longest, kv.second.size());
+        }
+        order.clear();
+        for (size_t i = 0; i < longest; ++i) {
+            for (auto& kv : byPkg) {
+                if (i < kv.second.size()) order.push_back(kv.second[i]);
+            }
+        }
+        break;
+    }
+    case PlacementPolicy::Nodes: {
+        std::vector<CpuInfo> kept;
+        for (const auto& c : order) {
+            if (std::find(placement.ids.begin(), placement.ids.end(), c.node) != placement.ids.end()) kept.push_back(c);
+        }
+        std::sort(kept.begin(), kept.end(), compact_less);
+        order.swap(kept);
+        break;
+    }
+    case PlacementPolicy::List: {
+        // keep the user's order; drop CPUs that are not online
+        std::vector<CpuInfo> kept;
+        for (int id : placement.ids) {
+            if (const CpuInfo* c = topo.find(id)) kept.push_back(*c);
+        }
+        order.swap(kept);
+        break;
+    }
+    }
+    std::vector<int> map;
+    if (order.empty()) return map;
+    map.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        map.push_back(order[static_cast<size_t>(i) % order.size()].cpu);
+    }
+    return map;
+}
+
+} // namespace lt
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace lt {
+
+// One logical CPU as described by /sys/devices/system/cpu.
+struct CpuInfo {
+    int cpu {0};      // logical CPU id (what pthread_setaffinity_np takes)
+    int core {0};     // topology/core_id (unique only within a package)
+    int package {0};  // topology/physical_package_id (socket)
+    int node {0};     // NUMA node id
+    int smt {0};      // rank among the SMT siblings of its physical core (0 = first thread)
+};
+
+// Online CPUs of this machine. On non-Linux platforms, or when sysfs is unavailable,
+// a flat single-socket layout with hardware_concurrency() CPUs is assumed.
+class Topology {
+public:
+    static Topology discover();
+
+    const std::vector<CpuInfo>& cpus() const { return cpus_; }
+    int num_cpus() const { return static_cast<int>(cpus_.size()); }
+    int num_cores() const;
+    int num_packages() const;
+    int num_nodes() const;
+    const CpuInfo* find(int cpu) const;
+
+    // e.g. "2 nodes, 2 packages, 48 cores, 96 cpus"
+    std::string summary() const;
+
+private:
+    std::vector<CpuInfo> cpus_; // sorted by logical CPU id
+};
+
+// How worker i is mapped onto a CPU.
+enum class PlacementPolicy {
+    RoundRobin,   // "rr": online CPUs in id order (historical default)
+    Compact,      // "compact": fill a node/package core by core, SMT siblings adjacent
+    Scatter,      // "scatter": alternate packages, physical cores before SMT siblings
+    PhysicalCore, // "core": one thread per physical core, siblings only once cores run out
+    Nodes,        // "node:0[,1..]": compact placement restricted to the listed NUMA nodes
+    List,         // "list:0,2,4-7": explicit CPU list, used in order
+};
+
+struct Placement {
+    PlacementPolicy policy {PlacementPolicy::RoundRobin};
+    std::vector<int> ids; // node ids for Nodes, CPU ids for List
+    std::string spec {"rr"};
+};
+
+// Parses a --placement value; returns false and fills err on a malformed spec.
+bool parse_placement(const std::string& spec, Placement& out, std::string& err);
+
+// Parses a sysfs-style CPU list ("0-3,8,10-11"); invalid tokens are skipped.
+std::vector<int> parse_cpu_list(const std::string& s);
+
+// CPU id for each of numThreads workers. When numThreads exceeds the CPUs the policy
+// selects, the order wraps around (oversubscription). Empty if the policy selects no CPU.
+std::vector<int> build_cpu_map(const Topology& topo, const Placement& placement, int numThreads);
+
+} // namespace lt
@@ -0,0 +1,137 @@
+#include "tscTimer.h"
+#include "Backoff.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace lt {
+
+std::uint64_t tsc_fallback_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+namespace {
+
+TscCalibration calibrate() {
+    TscCalibration c;
+#if defined(__x86_64__) || defined(__i386__)
+    c.source = "rdtsc";
+    unsigned a = 0, b = 0, cx = 0, d = 0;
+    if (__get_cpuid(0x80000007u, &a, &b, &cx, &d)) c.invariant = (d & (1u << 8)) != 0;
+#elif defined(__aarch64__)
+    c.source = "cntvct";
+    c.invariant = true; // the generic timer runs at a fixed frequency by definition
+#else
+    c.invariant = true;
+    return c;
+#endif
+    // median of three short windows: robust against one window disturbed by preemption
+    double rates[3];
+    for (double& r : rates) {
+        const std::uint64_t n0 = tsc_fallback_ns(), k0 = tsc_now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        const std::uint64_t n1 = tsc_fallback_ns(), k1 = tsc_now();
+        r = n1 > n0 ? static_cast<double>(k1 - k0) / static_cast<double>(n1 - n0) : 1.0;
+    }
+    double lo = std::min(rates[0], std::min(rates[1], rates[2]));
+    double hi = std::max(rates[0], std::max(rates[1], rates[2]));
+    c.ticksPerNs = rates[0] + rates[1] + rates[2] - lo - hi;
+    if (!(c.ticksPerNs > 0.0)) c.ticksPerNs = 1.0;
+    c.nsPerTick = 1.0 / c.ticksPerNs;
+    return c;
+}
+
+void pin_this_thread(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<unsigned>(cpu), &set);
+    (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+// Spin on an atomic until it equals want; yields after a while in case both threads
+// ended up on one CPU.
+void await(const std::atomic<std::uint64_t>& a, std::uint64_t want) {
+    unsigned spins = 0;
+    while (a.load(std::memory_order_acquire) != want) {
+        if (++spins < (1u << 16)) cpu_relax_once(); else yield_cpu();
+    }
+}
+
+} // namespace
+
+const TscCalibration& tsc_calibration() {
+    static const TscCalibration c = calibrate();
+    return c;
+}
+
+TscSkew measure_tsc_skew(const std::vector<int>& cpus) {
+    TscSkew out;
+    if (cpus.size() < 2) return out;
+    const double nsPerTick = tsc_calibration().nsPerTick;
+    constexpr int kTrials = 200;
+    double bestRtt = 0.0;
+    for (std::size_t i = 1; i < cpus.size(); ++i) {
+        if (cpus[i] == cpus[0]) continue;
+        std::atomic<std::uint64_t> req{0}, ack{0};
+        std::uint64_t remoteStamp = 0; // published by the release on ack
+        std::thread remote([&] {
+            pin_this_thread(cpus[i]);
+            for (std::uint64_t k = 1; k <= kTrials; ++k) {
+                await(req, k);
+                remoteStamp = tsc_now();
+                ack.store(k, std::memory_order_release);
+            }
+        });
+        double offset = 0.0, rtt = -1.0;
+        std::thread ref([&] {
+            pin_this_thread(cpus[0]);
+            for (std::uint64_t k = 1; k <= kTrials; ++k) {
+                const std::uint64_t t0 = tsc_now();
+                req.store(k, std::memory_order_release);
+                await(ack, k);
+                const std::uint64_t t1 = tsc_now();
+                const double r = static_cast<double>(t1 - t0);
+                if (rtt < 0.0 || r < rtt) {
+                    // the remote stamp lies inside [t0, t1]; its offset from the midpoint is the skew
+                    rtt = r;
+                    offset = static_cast<double>(remoteStamp) - (static_cast<double>(t0) + r / 2.0);
+                }
+            }
+        });
+        ref.join();
+        remote.join();
+        const double skewNs = std::fabs(offset) * nsPerTick;
+        if (out.worstCpu < 0 || skewNs > out.maxSkewNs) {
+            out.maxSkewNs = skewNs;
+            out.worstCpu = cpus[i];
+        }
+        if (bestRtt == 0.0 || rtt * nsPerTick < bestRtt) bestRtt = rtt * nsPerTick;
+    }
+    out.minRoundTripNs = bestRtt;
+    return out;
+}
+
+std::string tsc_summary(const TscCalibration& c) {
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "%s %s %.3f GHz", c.source, c.invariant ? "invariant" : "non-invariant", c.ticksPerNs);
+    return buf;
+}
+
+} // namespace lt
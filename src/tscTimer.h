@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace lt {
+
+// steady_clock in nanoseconds: the tsc_now() fallback on other architectures.
+std::uint64_t tsc_fallback_ns();
+
+// Cycle-resolution timestamps: RDTSC on x86, the generic timer (CNTVCT_EL0) on AArch64,
+// steady_clock nanoseconds elsewhere. Reading is unserialized (no fence), which is what a
+// back-to-back timestamp around lock()/unlock() wants: a few cycles, no pipeline drain.
+inline std::uint64_t tsc_now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t v;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return tsc_fallback_ns();
+#endif
+}
+
+// Result of the startup calibration (see tsc_calibration()).
+struct TscCalibration {
+    const char* source {"steady_clock"}; // "rdtsc", "cntvct" or "steady_clock"
+    bool invariant {false};   // constant rate across P-states and halts (x86: CPUID 0x80000007 EDX[8])
+    double ticksPerNs {1.0};  // measured against steady_clock
+    double nsPerTick {1.0};
+};
+
+// Calibrated once on first use (~50 ms) and cached; safe to call from any thread.
+const TscCalibration& tsc_calibration();
+
+inline std::uint64_t tsc_to_ns(std::uint64_t ticks) {
+    return static_cast<std::uint64_t>(static_cast<double>(ticks) * tsc_calibration().nsPerTick);
+}
+
+// Cross-core offset check: a thread pinned to each CPU answers timestamp ping-pongs from
+// a thread pinned to cpus[0]; the offset of a CPU is its reply minus the midpoint of the
+// round trip (best of many). Stamps taken on different CPUs are comparable to within
+// maxSkewNs, so differences below it are noise.
+struct TscSkew {
+    double maxSkewNs {0.0};
+    int worstCpu {-1};
+    double minRoundTripNs {0.0}; // fastest round trip seen (bounds the precision of the check)
+};
+
+TscSkew measure_tsc_skew(const std::vector<int>& cpus);
+
+// e.g. "rdtsc invariant 2.995 GHz"
+std::string tsc_summary(const TscCalibration& c);
+
+} // namespace lt
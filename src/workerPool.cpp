@@ -0,0 +1,102 @@
+#include "workerPool.h"
+
+#include "Futex.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace lt {
+
+namespace {
+
+void pin_this_thread(int cpu) {
+#if defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    if (cpu >= 0) {
+        CPU_SET(static_cast<unsigned>(cpu), &cpuset);
+    } else {
+        // unpinned: allow every CPU again
+        for (int c = 0; c < CPU_SETSIZE; ++c) CPU_SET(static_cast<unsigned>(c), &cpuset);
+    }
+    (void)pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#else
+    (void)cpu;
+#endif
+}
+
+} // namespace
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> g(mu_);
+        quit_ = true;
+        epoch_.fetch_add(1, std::memory_order_release);
+    }
+    futex_wake(&epoch_, INT_MAX);
+    for (auto& w : workers_) pthread_join(w->tid, nullptr);
+}
+
+void WorkerPool::dispatch(const std::vector<int>& cpus, Job job, void* arg) {
+    const int n = static_cast<int>(cpus.size());
+    std::lock_guard<std::mutex> g(mu_);
+    while (size() < n) {
+        // new workers start at the current epoch, so they only see jobs from now on
+        auto w = std::make_unique<Worker>(Worker{ this, size() });
+        w->seenEpoch = epoch_.load(std::memory_order_relaxed);
+        pthread_create(&w->tid, nullptr, &WorkerPool::thread_main, w.get());
+        workers_.push_back(std::move(w));
+    }
+    job_ = job;
+    arg_ = arg;
+    cpus_ = cpus;
+    pending_.store(n, std::memory_order_relaxed);
+    epoch_.fetch_add(1, std::memory_order_release);
+    futex_wake(&epoch_, INT_MAX);
+}
+
+void WorkerPool::wait() {
+    int p;
+    while ((p = pending_.load(std::memory_order_acquire)) != 0) {
+        futex_wait(&pending_, p);
+    }
+}
+
+void* WorkerPool::thread_main(void* arg) {
+    auto* w = static_cast<Worker*>(arg);
+    w->pool->worker_loop(*w);
+    return nullptr;
+}
+
+void WorkerPool::worker_loop(Worker& w) {
+    for (;;) {
+        int e;
+        while ((e = epoch_.load(std::memory_order_acquire)) == w.seenEpoch) {
+            futex_wait(&epoch_, e);
+        }
+        Job job;
+        void* arg;
+        int cpu;
+        {
+            // read epoch and job together: a lagging worker must not pair an old epoch with a new job
+            std::lock_guard<std::mutex> g(mu_);
+            w.seenEpoch = epoch_.load(std::memory_order_relaxed);
+            if (quit_) return;
+            if (w.index >= static_cast<int>(cpus_.size())) continue; // not part of this run
+            job = job_;
+            arg = arg_;
+            cpu = cpus_[static_cast<std::size_t>(w.index)];
+        }
+        if (cpu != w.pinnedCpu) {
+            pin_this_thread(cpu);
+            w.pinnedCpu = cpu;
+        }
+        job(w.index, arg);
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            futex_wake(&pending_, 1);
+        }
+    }
+}
+
+} // namespace lt
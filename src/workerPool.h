@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <pthread.h>
+
+namespace lt {
+
+// Persistent pinned worker threads reused across runs (repeats, thread counts, locks).
+// Each dispatch() opens a new epoch: workers 0..n-1 run the job, the rest go straight
+// back to sleep. Idle workers block in futex_wait on the epoch word, so they never spin
+// on CPUs that another run is measuring.
+class WorkerPool {
+public:
+    using Job = void (*)(int worker, void* arg);
+
+    WorkerPool() = default;
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Runs job(i, arg) on worker i for i < cpus.size(), each pinned to cpus[i] (< 0 = unpinned).
+    // Spawns missing workers on demand; returns without waiting (see wait()).
+    void dispatch(const std::vector<int>& cpus, Job job, void* arg);
+
+    // Blocks (futex, no spinning) until every worker of the last dispatch has returned.
+    void wait();
+
+    int size() const { return static_cast<int>(workers_.size()); }
+
+private:
+    struct Worker {
+        WorkerPool* pool;
+        int index;
+        int pinnedCpu {-2};   // CPU the thread is currently bound to (-2 = never pinned)
+        int seenEpoch {0};
+        pthread_t tid {};
+    };
+
+    static void* thread_main(void* arg);
+    void worker_loop(Worker& w);
+
+    std::mutex mu_;                  // guards the job fields below against lagging idle workers
+    std::atomic<int> epoch_ {0};     // futex word; bumped once per dispatch
+    std::atomic<int> pending_ {0};   // futex word; workers of the current job still running
+    bool quit_ {false};
+    Job job_ {nullptr};
+    void* arg_ {nullptr};
+    std::vector<int> cpus_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+} // namespace lt
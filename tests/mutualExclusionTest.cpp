@@ -0,0 +1,74 @@
+// Mutual-exclusion stress over every registered lock: worker threads (thread slots assigned
+// as LockTestSys does) increment a plain counter inside lock()/unlock() and flag any overlap
+// of two holders. A lock passes when nothing overlapped and no increment was lost
+// (tests/qspinRaceTest.cpp widens qspinlock's queue-head window on top of this).
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "registry.h"
+#include "ThreadSlot.h"
+
+using namespace lt;
+
+namespace {
+
+struct Shared {
+    std::atomic<int> inside {0};
+    std::atomic<std::uint64_t> overlaps {0};
+    std::uint64_t counter {0}; // only touched by the holder
+};
+
+bool check_lock(const std::string& name, int threads, int iters) {
+    LockConfig cfg;
+    cfg.maxThreads = threads;
+    std::unique_ptr<iLock> lock = make_lock(name, cfg);
+    if (!lock) {
+        std::cerr << name << ": cannot be created\n";
+        return false;
+    }
+    Shared sh;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            set_this_thread_slot(t);
+            for (int i = 0; i < iters; ++i) {
+                lock->lock();
+                if (sh.inside.fetch_add(1, std::memory_order_relaxed) != 0) sh.overlaps.fetch_add(1, std::memory_order_relaxed);
+                ++sh.counter;
+                sh.inside.fetch_sub(1, std::memory_order_relaxed);
+                lock->unlock();
+            }
+        });
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+    for (auto& w : workers) w.join();
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    const std::uint64_t expected = static_cast<std::uint64_t>(threads) * static_cast<std::uint64_t>(iters);
+    if (sh.overlaps.load() != 0 || sh.counter != expected) {
+        std::cerr << name << ": FAILED, counter " << sh.counter << " of " << expected << ", " << sh.overlaps.load()
+                  << " overlapping holders\n";
+        return false;
+    }
+    std::cout << name << ": ok (" << ms << " ms)" << std::endl;
+    return true;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    for (const auto& name : lock_names()) {
+        if (!check_lock(name, 4, 2000)) ++failures;
+    }
+    if (failures != 0) {
+        std::cerr << failures << " lock(s) failed\n";
+        return 1;
+    }
+    std::cout << lock_names().size() << " locks passed\n";
+    return 0;
+}
@@ -0,0 +1,51 @@
+// qspinlock queue-head handover under preemption: the head yields right after seeing the
+// lock free, so newcomers get every chance to slip in before its CAS / fetch_or. Built
+// without lock_test_core so the hook cannot clash with the harness's copy of QSpinLock.
+// Runs for a fixed time: on few CPUs every queued handover costs a time slice.
+#include <sched.h>
+#define LT_QSPIN_HEAD_HOOK() sched_yield()
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "locks/QSpinLock.h"
+
+int main() {
+    constexpr int kThreads = 4;
+    lt::QSpinLock lock;
+    std::atomic<bool> stop {false};
+    std::atomic<int> inside {0};
+    std::atomic<std::uint64_t> overlaps {0};
+    std::atomic<std::uint64_t> iterations {0};
+    std::uint64_t counter = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&, t] {
+            lt::set_this_thread_slot(t);
+            std::uint64_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                lock.lock();
+                if (inside.fetch_add(1, std::memory_order_relaxed) != 0) overlaps.fetch_add(1, std::memory_order_relaxed);
+                ++counter;
+                inside.fetch_sub(1, std::memory_order_relaxed);
+                lock.unlock();
+                ++n;
+            }
+            iterations.fetch_add(n, std::memory_order_relaxed);
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& w : workers) w.join();
+    if (overlaps.load() != 0 || counter != iterations.load()) {
+        std::cerr << "qspinlock: FAILED, counter " << counter << " of " << iterations.load() << ", " << overlaps.load()
+                  << " overlapping holders\n";
+        return 1;
+    }
+    std::cout << "qspinlock: ok (" << counter << " acquisitions)\n";
+    return 0;
+}